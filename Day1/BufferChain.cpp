@@ -0,0 +1,129 @@
+//
+// Created by Ayr on 2025/12/21.
+//
+#include "BufferChain.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+BufferChain::BufferChain(BufferPool &pool)
+    :pool{&pool}, segment_size{pool.buffer_bytes()} {
+    if (segment_size == 0) throw std::invalid_argument{"Buffer size must be positive"};
+}
+
+size_t BufferChain::size() const {
+    return write_offset - read_offset;
+}
+
+bool BufferChain::empty() const {
+    return write_offset == read_offset;
+}
+
+size_t BufferChain::segment_count() const {
+    return segments.size();
+}
+
+std::span<iovec> BufferChain::slices(size_t from, size_t to) {
+    iov.clear();
+    while (from < to && iov.size() < IOV_MAX) {
+        size_t segment = from / segment_size;
+        size_t offset = from % segment_size;
+        size_t len = std::min(segment_size - offset, to - from);
+        iov.push_back({segments[segment].data() + offset, len});
+        from += len;
+    }
+    return iov;
+}
+
+std::span<iovec> BufferChain::readable() {
+    return slices(read_offset, write_offset);
+}
+
+void BufferChain::consume(size_t n) {
+    if (n > size()) throw std::out_of_range{"Consume past the end of the chain"};
+    read_offset += n;
+
+    if (read_offset == write_offset) {
+        // 读空时游标归零，只留一段给后续写入
+        if (segments.size() > 1) segments.erase(segments.begin() + 1, segments.end());
+        read_offset = write_offset = 0;
+        return;
+    }
+    size_t done = read_offset / segment_size;
+    if (done) {
+        segments.erase(segments.begin(), segments.begin() + static_cast<std::ptrdiff_t>(done));
+        read_offset -= done * segment_size;
+        write_offset -= done * segment_size;
+    }
+}
+
+std::span<iovec> BufferChain::prepare(size_t n) {
+    while (segments.size() * segment_size - write_offset < n) {
+        segments.push_back(pool->acquire());
+    }
+    return slices(write_offset, write_offset + n);
+}
+
+void BufferChain::commit(size_t n) {
+    if (write_offset + n > segments.size() * segment_size) throw std::out_of_range{"Commit past prepared space"};
+    write_offset += n;
+}
+
+void BufferChain::append(const void *data, size_t n) {
+    auto src = static_cast<const char *>(data);
+    // prepare 一次最多给出 IOV_MAX 段，超长时分多轮
+    while (n) {
+        size_t round = 0;
+        for (auto &slice : prepare(n)) {
+            std::memcpy(slice.iov_base, src + round, slice.iov_len);
+            round += slice.iov_len;
+        }
+        commit(round);
+        src += round;
+        n -= round;
+    }
+}
+
+size_t BufferChain::read(void *out, size_t n) {
+    n = std::min(n, size());
+    auto dst = static_cast<char *>(out);
+    size_t copied = 0;
+    while (copied < n) {
+        size_t round = 0;
+        for (auto &slice : readable()) {
+            size_t len = std::min(slice.iov_len, n - copied - round);
+            std::memcpy(dst + copied + round, slice.iov_base, len);
+            round += len;
+            if (copied + round == n) break;
+        }
+        consume(round);
+        copied += round;
+    }
+    return n;
+}
+
+#ifndef _WIN32
+ssize_t BufferChain::read_from(int fd, size_t max_bytes) {
+    auto slices = prepare(max_bytes);
+    ssize_t n = ::readv(fd, slices.data(), static_cast<int>(slices.size()));
+    if (n > 0) commit(static_cast<size_t>(n));
+    return n;
+}
+
+ssize_t BufferChain::write_to(int fd) {
+    auto slices = readable();
+    if (slices.empty()) return 0;
+    ssize_t n = ::writev(fd, slices.data(), static_cast<int>(slices.size()));
+    if (n > 0) consume(static_cast<size_t>(n));
+    return n;
+}
+#endif
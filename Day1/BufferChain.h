@@ -0,0 +1,69 @@
+//
+// Created by Ayr on 2025/12/21.
+//
+
+#ifndef DAY1_BUFFERCHAIN_H
+#define DAY1_BUFFERCHAIN_H
+#include "BufferPool.h"
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#ifdef _WIN32
+// 与 POSIX 的 iovec 同布局，便于上层统一处理
+struct iovec {
+    void *iov_base;
+    size_t iov_len;
+};
+#else
+#include <sys/types.h>
+#include <sys/uio.h>
+#endif
+
+// 由若干池内 Buffer 串成的字节队列，尾部追加、头部消费
+// readable() / prepare() 直接给出 iovec 数组，配合 readv / writev / preadv 实现零拷贝收发
+class BufferChain {
+    BufferPool *pool;
+    size_t segment_size;
+    std::vector<Buffer> segments;
+    // 两个游标都从 segments[0] 起算
+    size_t read_offset = 0;
+    size_t write_offset = 0;
+    // 复用的 iovec 数组，稳定后不再分配
+    std::vector<iovec> iov;
+
+    std::span<iovec> slices(size_t from, size_t to);
+public:
+    explicit BufferChain(BufferPool &pool);
+
+    BufferChain(const BufferChain &) = delete;
+    BufferChain(BufferChain &&) noexcept = default;
+
+    BufferChain &operator=(const BufferChain &) = delete;
+    BufferChain &operator=(BufferChain &&) noexcept = default;
+
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] size_t segment_count() const;
+
+    // 可读区间，交给 writev；一次最多 IOV_MAX 段
+    std::span<iovec> readable();
+    // 释放前 n 个可读字节，读完的整段立即还给池
+    void consume(size_t n);
+
+    // 确保尾部至少有 n 字节可写空间（不够时从池里取），交给 readv
+    std::span<iovec> prepare(size_t n);
+    // 把 prepare 出来的前 n 字节计入可读区
+    void commit(size_t n);
+
+    // 拷贝式的便捷接口
+    void append(const void *data, size_t n);
+    size_t read(void *out, size_t n);
+
+#ifndef _WIN32
+    // 从 fd 读入至多 max_bytes 字节 / 把可读内容写到 fd，返回值同 readv / writev
+    ssize_t read_from(int fd, size_t max_bytes);
+    ssize_t write_to(int fd);
+#endif
+};
+#endif //DAY1_BUFFERCHAIN_H
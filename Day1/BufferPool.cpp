@@ -3,12 +3,109 @@
 //
 #include "BufferPool.h"
 #include <stdexcept>
+#include <thread>
+#include <algorithm>
+#include <bit>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+    // 字内 [lo, hi) 位的掩码
+    uint64_t range_mask(size_t lo, size_t hi) {
+        return hi - lo == 64 ? ~uint64_t{0} : ((uint64_t{1} << (hi - lo)) - 1) << lo;
+    }
+
+    std::atomic<uint64_t> next_uid{1};
+
+    int64_t now_ticks() {
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+
+    // 统计分片数；线程按创建顺序轮流分到各分片，线程数不超过分片数时互不干扰
+    constexpr size_t stat_shard_count = 16;
+    std::atomic<size_t> next_stat_shard{0};
+
+    size_t wait_bucket(std::chrono::steady_clock::duration waited) {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(waited).count();
+        if (us <= 0) return 0;
+        return std::min<size_t>(std::bit_width(static_cast<uint64_t>(us)), BufferPoolStats::wait_buckets - 1);
+    }
+}
+
+uint64_t BufferPoolStats::bucket_limit_us(size_t bucket) {
+    return bucket + 1 >= wait_buckets ? 0 : uint64_t{1} << bucket;
+}
+
+uint64_t BufferPoolStats::wait_percentile_us(double q) const {
+    uint64_t total = 0;
+    for (auto n : wait_histogram) total += n;
+    if (!total) return 0;
+
+    auto target = static_cast<uint64_t>(q * static_cast<double>(total));
+    uint64_t seen = 0;
+    for (size_t k = 0; k < wait_buckets; k++) {
+        seen += wait_histogram[k];
+        if (seen > target || seen == total) return bucket_limit_us(k);
+    }
+    return 0;
+}
+
+// 一个线程（或共享同一分片的几个线程）的计数，独占 cache line
+struct alignas(64) BufferPool::StatShard {
+    std::atomic<uint64_t> acquires{0};
+    std::atomic<uint64_t> releases{0};
+    std::atomic<uint64_t> failures{0};
+    std::atomic<uint64_t> waits{0};
+    std::array<std::atomic<uint64_t>, BufferPoolStats::wait_buckets> wait_histogram{};
+};
+
+// 线程本地缓存：只有所属线程存取，耗尽回收和统计时才会被其他线程短暂加锁
+struct BufferPool::Magazine {
+    std::atomic_flag locked;
+    // 池析构或线程退出后置空，受 locked 保护
+    BufferPool *pool;
+    uint64_t uid;
+
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    size_t count = 0;
+    std::vector<uint32_t> items;
+
+    Magazine(BufferPool *pool, uint64_t uid, size_t capacity)
+        : pool{pool}, uid{uid}, items(capacity) {}
+
+    void lock() {
+        while (locked.test_and_set(std::memory_order_acquire)) std::this_thread::yield();
+    }
+    void unlock() {
+        locked.clear(std::memory_order_release);
+    }
+    bool detached() {
+        lock();
+        bool result = pool == nullptr;
+        unlock();
+        return result;
+    }
+};
+
+struct BufferPool::MagazineCache {
+    std::vector<std::shared_ptr<Magazine>> magazines;
+    uint64_t last_uid = 0;
+    Magazine *last = nullptr;
+
+    ~MagazineCache() {
+        for (auto &m : magazines) retire(m.get());
+    }
+};
 
 Buffer::Buffer(size_t buffer_id, char *buffer, void(*callback)(size_t, void*), void* p)
     :buffer_id{buffer_id}, buffer{buffer}, callback{callback}, p{p} {}
 
 Buffer::~Buffer() noexcept {
-    callback(buffer_id, p);
+    // 被移走的 Buffer 不持有任何缓冲区
+    if (callback) callback(buffer_id, p);
 }
 
 Buffer::Buffer(Buffer && other) noexcept {
@@ -24,6 +121,10 @@ Buffer::Buffer(Buffer && other) noexcept {
 }
 
 Buffer &Buffer::operator=(Buffer && other) noexcept {
+    if (this == &other) return *this;
+    // 先归还自己原本持有的缓冲区
+    if (callback) callback(buffer_id, p);
+
     buffer_id = other.buffer_id;
     buffer = other.buffer;
     callback = other.callback;
@@ -43,35 +144,680 @@ Buffer &Buffer::operator=(Buffer && other) noexcept {
 
 // ----
 
-BufferPool::BufferPool(size_t buffer_size, size_t pool_size)
-    :buffer_size{buffer_size}, pool_size{pool_size} {
-    buffer = new char[buffer_size * pool_size];
-    used = new bool[pool_size]{false};
+BufferPool::BufferPool(size_t buffer_size, size_t pool_size, const BufferPoolOptions &options)
+    :buffer_size{buffer_size},
+     buffer_stride{options.alignment ? (buffer_size + options.alignment - 1) & ~(options.alignment - 1) : buffer_size},
+     pool_size{pool_size},
+     magazine_capacity{options.magazine_size}, magazine_batch{std::max<size_t>(1, options.magazine_size / 2)},
+     uid{next_uid.fetch_add(1, std::memory_order_relaxed)},
+     shrink_cooldown{options.shrink_cooldown},
+     allocator{options.storage, options.alignment, options.huge_pages, options.prefault} {
+    bool elastic = options.max_pool_size > pool_size;
+    if (elastic) {
+        // slab 取 2 的幂，下标换算只需移位
+        slab_buffers = std::bit_ceil(std::max<size_t>(1, options.slab_size ? options.slab_size : pool_size));
+        slab_shift = std::countr_zero(slab_buffers);
+        slab_mask = slab_buffers - 1;
+        min_slabs = (pool_size + slab_buffers - 1) / slab_buffers;
+        max_slabs = (options.max_pool_size + slab_buffers - 1) / slab_buffers;
+        this->pool_size = max_slabs * slab_buffers;
+    } else {
+        slab_buffers = pool_size;
+        slab_shift = 32;
+        slab_mask = SIZE_MAX;
+        min_slabs = max_slabs = 1;
+    }
+    // 下标用 32 位存储，npos 留作“没有空闲”
+    if (this->pool_size >= npos) throw std::invalid_argument{"Pool size is too large"};
+
+    bitmap_words = (this->pool_size + 63) / 64;
+    free_bits = std::make_unique<std::atomic<uint64_t>[]>(bitmap_words);
+    share_counts = std::make_unique<std::atomic<uint32_t>[]>(this->pool_size);
+    slabs = std::make_unique<char *[]>(max_slabs);
+    if (elastic) slab_states = std::make_unique<SlabState[]>(max_slabs);
+    stat_shards = std::make_unique<StatShard[]>(stat_shard_count);
+
+    size_t k = 0;
+    try {
+        for (; k < min_slabs; k++) {
+            slabs[k] = allocator.allocate(slab_buffers * buffer_stride);
+            set_free(k * slab_buffers, slab_buffers);
+        }
+    } catch (...) {
+        // 析构函数不会运行，已映射的 slab 要在这里释放
+        while (k--) allocator.deallocate(slabs[k], slab_buffers * buffer_stride);
+        throw;
+    }
+    slab_count.store(min_slabs, std::memory_order_release);
 }
 
 BufferPool::~BufferPool() noexcept {
-    delete[] buffer;
-    delete[] used;
+    // 断开各线程缓存，之后线程退出时不会再访问本池
+    {
+        std::lock_guard lock(magazines_mtx);
+        for (auto &m : magazines) {
+            m->lock();
+            m->pool = nullptr;
+            m->unlock();
+        }
+    }
+    size_t count = slab_count.load(std::memory_order_acquire);
+    for (size_t k = 0; k < count; k++) allocator.deallocate(slabs[k], slab_buffers * buffer_stride);
 }
 
 void BufferPool::callback(size_t buffer_id, void *p) {
     auto other = static_cast<BufferPool *>(p);
     if (buffer_id + 1 > other->pool_size) return;
 
-    other->used[buffer_id] = false;
+    other->release(static_cast<uint32_t>(buffer_id));
+}
+
+uint32_t BufferPool::pop() {
+    // 快速路径：提示字里还有空闲位
+    size_t w = hint.load(std::memory_order_relaxed);
+    if (w < bitmap_words) {
+        uint64_t bits = free_bits[w].load(std::memory_order_relaxed);
+        while (bits) {
+            if (free_bits[w].compare_exchange_weak(bits, bits & (bits - 1),
+                                                   std::memory_order_acquire, std::memory_order_relaxed)) {
+                auto index = static_cast<uint32_t>(w * 64 + std::countr_zero(bits));
+                taken_from_central(&index, 1);
+                return index;
+            }
+        }
+    }
+    uint32_t index;
+    return pop_batch(&index, 1) ? index : npos;
+}
+
+void BufferPool::push(uint32_t index) {
+    free_bits[index / 64].fetch_or(uint64_t{1} << (index % 64), std::memory_order_release);
+    returned_to_central(&index, 1);
+}
+
+size_t BufferPool::pop_batch(uint32_t *out, size_t n) {
+    size_t words = active_words();
+    if (!words || !n) return 0;
+
+    size_t start = hint.load(std::memory_order_relaxed);
+    if (start >= words) start = 0;
+    size_t taken = 0;
+    size_t last = start;
+
+    // 从 start 扫到末尾，再从头扫到 start
+    for (auto [lo, hi] : {std::pair{start, words}, std::pair{size_t{0}, start}}) {
+        for (size_t w = find_word(lo, hi); w < hi && taken < n; w = find_word(w + 1, hi)) {
+            uint64_t bits = free_bits[w].load(std::memory_order_relaxed);
+            while (bits) {
+                // 只取最低的 n - taken 个空闲位
+                uint64_t take = bits;
+                if (static_cast<size_t>(std::popcount(bits)) > n - taken) {
+                    take = 0;
+                    uint64_t rest = bits;
+                    for (size_t k = taken; k < n; k++) {
+                        take |= rest & (~rest + 1);
+                        rest &= rest - 1;
+                    }
+                }
+                if (free_bits[w].compare_exchange_weak(bits, bits & ~take,
+                                                       std::memory_order_acquire, std::memory_order_relaxed)) {
+                    for (; take; take &= take - 1) {
+                        out[taken++] = static_cast<uint32_t>(w * 64 + std::countr_zero(take));
+                    }
+                    last = w;
+                    break;
+                }
+            }
+        }
+        if (taken == n) break;
+    }
+
+    if (!taken) return 0;
+    if (last != start) hint.store(last, std::memory_order_relaxed);
+    taken_from_central(out, taken);
+    return taken;
+}
+
+void BufferPool::push_batch(const uint32_t *indices, size_t n) {
+    // 相邻且落在同一个字里的下标合并成一次 fetch_or
+    for (size_t i = 0; i < n;) {
+        size_t w = indices[i] / 64;
+        uint64_t mask = 0;
+        for (; i < n && indices[i] / 64 == w; i++) mask |= uint64_t{1} << (indices[i] % 64);
+        free_bits[w].fetch_or(mask, std::memory_order_release);
+    }
+    returned_to_central(indices, n);
+}
+
+size_t BufferPool::active_words() const {
+    return (slab_count.load(std::memory_order_acquire) * slab_buffers + 63) / 64;
+}
+
+size_t BufferPool::find_word(size_t from, size_t to) const {
+    size_t w = from;
+#if defined(__AVX2__)
+    // 一次检查 4 个字（256 个缓冲区）；读到的只是提示，真正取用靠 CAS
+    static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t));
+    for (; w + 4 <= to; w += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(free_bits.get() + w));
+        if (!_mm256_testz_si256(v, v)) break;
+    }
+#else
+    for (; w + 4 <= to; w += 4) {
+        if (free_bits[w].load(std::memory_order_relaxed) | free_bits[w + 1].load(std::memory_order_relaxed) |
+            free_bits[w + 2].load(std::memory_order_relaxed) | free_bits[w + 3].load(std::memory_order_relaxed)) break;
+    }
+#endif
+    for (; w < to; w++) {
+        if (free_bits[w].load(std::memory_order_relaxed)) return w;
+    }
+    return to;
+}
+
+void BufferPool::set_free(size_t first, size_t count) {
+    for (size_t i = first, end = first + count; i < end;) {
+        size_t w = i / 64;
+        size_t hi = std::min(end, (w + 1) * 64);
+        free_bits[w].fetch_or(range_mask(i % 64, hi - w * 64), std::memory_order_release);
+        i = hi;
+    }
+}
+
+bool BufferPool::claim_range(size_t first, size_t count) {
+    for (size_t i = first, end = first + count; i < end;) {
+        size_t w = i / 64;
+        size_t hi = std::min(end, (w + 1) * 64);
+        uint64_t mask = range_mask(i % 64, hi - w * 64);
+        uint64_t bits = free_bits[w].load(std::memory_order_relaxed);
+        do {
+            if ((bits & mask) != mask) {
+                // 有缓冲区被取走了，把已经拿到的放回去
+                set_free(first, i - first);
+                return false;
+            }
+        } while (!free_bits[w].compare_exchange_weak(bits, bits & ~mask,
+                                                     std::memory_order_acquire, std::memory_order_relaxed));
+        i = hi;
+    }
+    return true;
+}
+
+BufferPool::StatShard &BufferPool::local_stats() {
+    thread_local size_t shard = next_stat_shard.fetch_add(1, std::memory_order_relaxed) % stat_shard_count;
+    return stat_shards[shard];
+}
+
+void BufferPool::record_wait(std::chrono::steady_clock::time_point since) {
+    StatShard &stats = local_stats();
+    stats.waits.fetch_add(1, std::memory_order_relaxed);
+    stats.wait_histogram[wait_bucket(std::chrono::steady_clock::now() - since)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void BufferPool::record_failure() {
+    local_stats().failures.fetch_add(1, std::memory_order_relaxed);
+}
+
+void BufferPool::taken_from_central(const uint32_t *indices, size_t n) {
+    // 只在中心位图变化时更新，线程缓存命中不碰这两个共享计数
+    size_t now = outstanding.fetch_add(n, std::memory_order_relaxed) + n;
+    size_t peak = peak_outstanding.load(std::memory_order_relaxed);
+    while (now > peak && !peak_outstanding.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+
+    if (!slab_states) return;
+    for (size_t i = 0; i < n; i++) {
+        slab_states[indices[i] >> slab_shift].in_use.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void BufferPool::returned_to_central(const uint32_t *indices, size_t n) {
+    outstanding.fetch_sub(n, std::memory_order_relaxed);
+    if (!slab_states) return;
+    bool idle = false;
+    for (size_t i = 0; i < n; i++) {
+        SlabState &state = slab_states[indices[i] >> slab_shift];
+        if (state.in_use.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            state.idle_since.store(now_ticks(), std::memory_order_relaxed);
+            idle = true;
+        }
+    }
+    // 有 slab 变空闲时顺带检查能否收缩；拿不到锁说明别人正在扩缩容，跳过即可
+    if (idle && slab_count.load(std::memory_order_relaxed) > min_slabs && grow_mtx.try_lock()) {
+        shrink_locked();
+        grow_mtx.unlock();
+    }
+}
+
+void BufferPool::adopt(uint32_t index) {
+    share_counts[index].store(1, std::memory_order_relaxed);
+}
+
+void BufferPool::retain(uint32_t index) {
+    // 新引用总是从已有引用复制而来，不需要同步
+    share_counts[index].fetch_add(1, std::memory_order_relaxed);
+}
+
+void BufferPool::drop(uint32_t index) {
+    // acq_rel：之前各持有者对缓冲区的访问都发生在归还之前
+    if (share_counts[index].fetch_sub(1, std::memory_order_acq_rel) == 1) release(index);
+}
+
+size_t BufferPool::share_count(uint32_t index) const {
+    return share_counts[index].load(std::memory_order_relaxed);
+}
+
+char *BufferPool::address(uint32_t index) const {
+    return slabs[static_cast<uint64_t>(index) >> slab_shift] + (index & slab_mask) * buffer_stride;
+}
+
+uint32_t BufferPool::grow() {
+    if (slab_count.load(std::memory_order_relaxed) == max_slabs) return npos;
+
+    std::lock_guard lock(grow_mtx);
+    // 等锁期间可能已有归还、扩容或收缩结束
+    uint32_t index = pop();
+    if (index != npos) return index;
+
+    size_t k = slab_count.load(std::memory_order_relaxed);
+    if (k == max_slabs) return npos;
+
+    slabs[k] = allocator.allocate(slab_buffers * buffer_stride);
+    auto first = static_cast<uint32_t>(k * slab_buffers);
+    // 第一个直接返回，其余标记为空闲
+    set_free(first + 1, slab_buffers - 1);
+    slab_count.store(k + 1, std::memory_order_release);
+    taken_from_central(&first, 1);
+    return first;
+}
+
+size_t BufferPool::shrink_locked() {
+    size_t freed = 0;
+    int64_t now = now_ticks();
+    while (slab_count.load(std::memory_order_relaxed) > min_slabs) {
+        size_t k = slab_count.load(std::memory_order_relaxed) - 1;
+        SlabState &state = slab_states[k];
+        if (state.in_use.load(std::memory_order_acquire) != 0) break;
+        if (now - state.idle_since.load(std::memory_order_relaxed) < shrink_cooldown.count()) break;
+
+        // 整段取走 slab k 的空闲位；期间有 acquire 扫不到空闲位会进入 grow()，在 grow_mtx 上等到这里结束
+        if (!claim_range(k * slab_buffers, slab_buffers)) break;
+
+        allocator.deallocate(slabs[k], slab_buffers * buffer_stride);
+        slabs[k] = nullptr;
+        slab_count.store(k, std::memory_order_release);
+        freed++;
+    }
+    return freed;
+}
+
+uint32_t BufferPool::take() {
+    if (!magazine_capacity) {
+        uint32_t index = pop();
+        return index != npos ? index : grow();
+    }
+
+    Magazine *m = local_magazine();
+    m->lock();
+    if (m->count) {
+        m->hits++;
+        uint32_t index = m->items[--m->count];
+        m->unlock();
+        return index;
+    }
+    m->misses++;
+    m->count = pop_batch(m->items.data(), magazine_batch);
+    if (m->count) {
+        uint32_t index = m->items[--m->count];
+        m->unlock();
+        return index;
+    }
+    m->unlock();
+
+    // 中心位图已空，缓冲区可能都躺在各线程缓存里
+    reclaim_magazines();
+    uint32_t index = pop();
+    return index != npos ? index : grow();
+}
+
+void BufferPool::release(uint32_t index) {
+    local_stats().releases.fetch_add(1, std::memory_order_relaxed);
+    if (!magazine_capacity) {
+        release_central(index);
+        return;
+    }
+
+    Magazine *m = local_magazine();
+    bool flushed = false;
+    m->lock();
+    if (m->count == magazine_capacity) {
+        // 缓存已满，把一半还给中心位图
+        m->misses++;
+        m->count -= magazine_batch;
+        push_batch(m->items.data() + m->count, magazine_batch);
+        flushed = true;
+    } else {
+        m->hits++;
+    }
+    m->items[m->count++] = index;
+    m->unlock();
+
+    // 有人在等待时不再囤积：要么这里看到等待者，要么等待者登记后回收时看到这个缓冲区
+    if (waiting.load(std::memory_order_relaxed) > 0) {
+        m->lock();
+        push_batch(m->items.data(), m->count);
+        m->count = 0;
+        m->unlock();
+        flushed = true;
+    }
+    if (flushed) notify_waiters();
+}
+
+void BufferPool::release_central(uint32_t index) {
+    if (waiting.load(std::memory_order_relaxed) > 0) {
+        std::unique_lock lock(mtx);
+        if (waiters_head) {
+            Waiter *resume = wake_front(index, nullptr);
+            lock.unlock();
+            resume_all(resume);
+            return;
+        }
+    }
+
+    push(index);
+    notify_waiters();
+}
+
+void BufferPool::notify_waiters() {
+    // 与 park 中的 "登记 -> 取位图" 相对：要么这里看到等待者，要么等待者看到这次 push
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting.load(std::memory_order_relaxed) > 0) {
+        std::unique_lock lock(mtx);
+        Waiter *resume = drain(nullptr);
+        lock.unlock();
+        resume_all(resume);
+    }
+}
+
+Buffer BufferPool::make_buffer(uint32_t index) {
+    local_stats().acquires.fetch_add(1, std::memory_order_relaxed);
+    return Buffer{
+        index,
+        address(index),
+        callback,
+        this
+    };
+}
+
+void BufferPool::enqueue(Waiter *w) {
+    w->prev = waiters_tail;
+    w->next = nullptr;
+    if (waiters_tail) waiters_tail->next = w;
+    else waiters_head = w;
+    waiters_tail = w;
+    waiting.fetch_add(1, std::memory_order_relaxed);
+}
+
+void BufferPool::dequeue(Waiter *w) {
+    if (w->prev) w->prev->next = w->next;
+    else waiters_head = w->next;
+    if (w->next) w->next->prev = w->prev;
+    else waiters_tail = w->prev;
+    w->prev = w->next = nullptr;
+    waiting.fetch_sub(1, std::memory_order_relaxed);
+}
+
+BufferPool::Waiter *BufferPool::wake_front(uint32_t index, Waiter *resume) {
+    Waiter *w = waiters_head;
+    dequeue(w);
+    w->index = index;
+    w->ready = true;
+    if (w->handle) {
+        // 复用 next 串起待恢复的协程
+        w->next = resume;
+        return w;
+    }
+    // 必须在锁内通知：解锁后等待方可能已返回，cv 随之销毁
+    if (w->cv) w->cv->notify_one();
+    return resume;
+}
+
+BufferPool::Waiter *BufferPool::drain(Waiter *resume) {
+    while (waiters_head) {
+        uint32_t index = pop();
+        if (index == npos) break;
+        resume = wake_front(index, resume);
+    }
+    return resume;
+}
+
+bool BufferPool::park(Waiter *w, std::coroutine_handle<> handle) {
+    std::unique_lock lock(mtx);
+    enqueue(w);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (magazine_capacity) reclaim_magazines();
+    // 登记前归还的缓冲区留在位图里，按 FIFO 交给排在前面的等待者（可能就是自己）
+    Waiter *resume = drain(nullptr);
+    bool parked = !w->ready;
+    // 协程句柄在这里才挂上，避免 drain 把自己放进 resume 链
+    if (parked) w->handle = handle;
+    lock.unlock();
+
+    resume_all(resume);
+    return parked;
+}
+
+void BufferPool::resume_all(Waiter *resume) {
+    while (resume) {
+        // 恢复后协程帧（以及其中的 Waiter）可能已被销毁，先取 next
+        Waiter *w = resume;
+        resume = resume->next;
+        w->handle.resume();
+    }
 }
 
 Buffer BufferPool::acquire() {
-    for (size_t buffer_id = 0; buffer_id < pool_size; buffer_id++) {
-        if (!used[buffer_id]) {
-            used[buffer_id] = true;
-            return Buffer{
-                buffer_id,
-                buffer + buffer_id * buffer_size,
-                callback,
-                this
-            };
+    uint32_t index = take();
+    if (index == npos) {
+        record_failure();
+        throw std::runtime_error{"Cannot find a free space"};
+    }
+    return make_buffer(index);
+}
+
+std::optional<Buffer> BufferPool::try_acquire() {
+    uint32_t index = take();
+    if (index == npos) {
+        record_failure();
+        return std::nullopt;
+    }
+    return make_buffer(index);
+}
+
+Buffer BufferPool::acquire_wait() {
+    uint32_t index = take();
+    if (index != npos) return make_buffer(index);
+
+    std::condition_variable cv;
+    Waiter w;
+    w.cv = &cv;
+    w.since = std::chrono::steady_clock::now();
+    if (park(&w, nullptr)) {
+        std::unique_lock lock(mtx);
+        cv.wait(lock, [&w] { return w.ready; });
+    }
+    record_wait(w.since);
+    return make_buffer(w.index);
+}
+
+std::optional<Buffer> BufferPool::try_acquire_until(std::chrono::steady_clock::time_point deadline) {
+    uint32_t index = take();
+    if (index != npos) return make_buffer(index);
+
+    std::condition_variable cv;
+    Waiter w;
+    w.cv = &cv;
+    w.since = std::chrono::steady_clock::now();
+    if (park(&w, nullptr)) {
+        std::unique_lock lock(mtx);
+        if (!cv.wait_until(lock, deadline, [&w] { return w.ready; })) {
+            dequeue(&w);
+            lock.unlock();
+            record_failure();
+            return std::nullopt;
         }
     }
-    throw std::runtime_error{"Cannot find a free space"};
-}
\ No newline at end of file
+    record_wait(w.since);
+    return make_buffer(w.index);
+}
+
+bool BufferPool::AcquireAwaiter::await_ready() {
+    waiter.index = pool->take();
+    return waiter.index != npos;
+}
+
+bool BufferPool::AcquireAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    waiter.since = std::chrono::steady_clock::now();
+    return pool->park(&waiter, handle);
+}
+
+Buffer BufferPool::AcquireAwaiter::await_resume() {
+    // 只有走过 await_suspend 的才算等待
+    if (waiter.since != std::chrono::steady_clock::time_point{}) pool->record_wait(waiter.since);
+    return pool->make_buffer(waiter.index);
+}
+
+BufferPool::AcquireAwaiter BufferPool::acquire_async() {
+    return AcquireAwaiter{this};
+}
+
+BufferPool::Magazine *BufferPool::local_magazine() {
+    thread_local MagazineCache cache;
+    if (cache.last_uid == uid) return cache.last;
+
+    auto it = std::find_if(cache.magazines.begin(), cache.magazines.end(),
+                           [this](auto &m) { return m->uid == uid; });
+    if (it == cache.magazines.end()) {
+        // 顺便清理已析构的池留下的缓存
+        std::erase_if(cache.magazines, [](auto &m) { return m->detached(); });
+
+        auto m = std::make_shared<Magazine>(this, uid, magazine_capacity);
+        {
+            std::lock_guard lock(magazines_mtx);
+            std::erase_if(magazines, [](auto &other) { return other->detached(); });
+            magazines.push_back(m);
+        }
+        cache.magazines.push_back(m);
+        it = cache.magazines.end() - 1;
+    }
+    cache.last_uid = uid;
+    cache.last = it->get();
+    return cache.last;
+}
+
+void BufferPool::reclaim_magazines() {
+    std::lock_guard lock(magazines_mtx);
+    for (auto &m : magazines) {
+        m->lock();
+        if (m->pool) {
+            push_batch(m->items.data(), m->count);
+            m->count = 0;
+        }
+        m->unlock();
+    }
+}
+
+void BufferPool::retire(Magazine *m) {
+    m->lock();
+    if (BufferPool *pool = m->pool) {
+        pool->push_batch(m->items.data(), m->count);
+        m->count = 0;
+        pool->retired_hits.fetch_add(m->hits, std::memory_order_relaxed);
+        pool->retired_misses.fetch_add(m->misses, std::memory_order_relaxed);
+        m->pool = nullptr;
+    }
+    m->unlock();
+}
+
+size_t BufferPool::buffer_bytes() const {
+    return buffer_size;
+}
+
+size_t BufferPool::capacity() const {
+    return slab_count.load(std::memory_order_relaxed) * slab_buffers;
+}
+
+size_t BufferPool::max_capacity() const {
+    return pool_size;
+}
+
+size_t BufferPool::trim() {
+    if (!slab_states) return 0;
+
+    if (magazine_capacity) reclaim_magazines();
+    size_t freed;
+    {
+        std::lock_guard lock(grow_mtx);
+        freed = shrink_locked();
+    }
+    notify_waiters();
+    return freed;
+}
+
+size_t BufferPool::in_use() const {
+    // 先汇总 releases 再汇总 acquires，尽量不出现只看到归还、没看到对应取出的情况
+    uint64_t releases = 0;
+    for (size_t i = 0; i < stat_shard_count; i++) releases += stat_shards[i].releases.load(std::memory_order_relaxed);
+    uint64_t acquires = 0;
+    for (size_t i = 0; i < stat_shard_count; i++) acquires += stat_shards[i].acquires.load(std::memory_order_relaxed);
+    return acquires > releases ? static_cast<size_t>(acquires - releases) : 0;
+}
+
+size_t BufferPool::high_water() const {
+    return std::max(peak_outstanding.load(std::memory_order_relaxed), in_use());
+}
+
+BufferPoolStats BufferPool::stats() const {
+    BufferPoolStats result;
+    result.capacity = capacity();
+    result.max_capacity = max_capacity();
+    result.in_use = in_use();
+    result.high_water = std::max(peak_outstanding.load(std::memory_order_relaxed), result.in_use);
+    for (size_t i = 0; i < stat_shard_count; i++) {
+        const StatShard &shard = stat_shards[i];
+        result.acquires += shard.acquires.load(std::memory_order_relaxed);
+        result.releases += shard.releases.load(std::memory_order_relaxed);
+        result.failures += shard.failures.load(std::memory_order_relaxed);
+        result.waits += shard.waits.load(std::memory_order_relaxed);
+        for (size_t k = 0; k < BufferPoolStats::wait_buckets; k++) {
+            result.wait_histogram[k] += shard.wait_histogram[k].load(std::memory_order_relaxed);
+        }
+    }
+    // 没有等待的 acquire 都算在第 0 档
+    result.wait_histogram[0] += result.acquires > result.waits ? result.acquires - result.waits : 0;
+    result.magazine_hit_ratio = magazine_hit_ratio();
+    return result;
+}
+
+size_t BufferPool::huge_page_slabs() const {
+    return allocator.huge_page_slabs();
+}
+
+size_t BufferPool::magazine_size() const {
+    return magazine_capacity;
+}
+
+double BufferPool::magazine_hit_ratio() const {
+    uint64_t hits = retired_hits.load(std::memory_order_relaxed);
+    uint64_t misses = retired_misses.load(std::memory_order_relaxed);
+    {
+        std::lock_guard lock(magazines_mtx);
+        for (auto &m : magazines) {
+            m->lock();
+            if (m->pool) {
+                hits += m->hits;
+                misses += m->misses;
+            }
+            m->unlock();
+        }
+    }
+    return hits + misses ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0;
+}
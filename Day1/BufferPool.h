@@ -5,7 +5,20 @@
 #ifndef DAY1_BUFFERPOOL_H
 #define DAY1_BUFFERPOOL_H
 #include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <array>
+#include <mutex>
+#include <optional>
+#include <memory>
+#include <vector>
+#include "SlabAllocator.h"
 class Buffer {
+    friend class SharedBuffer;
+
     size_t buffer_id;
     char *buffer;
     void(*callback)(size_t, void*);
@@ -23,14 +36,205 @@ public:
     [[nodiscard]] char *data() const;
 };
 
+struct BufferPoolOptions {
+    // 每个线程本地缓存（magazine）最多存放的空闲缓冲区数，0 表示不使用
+    // 本地缓存空了从中心位图批量取 magazine_size / 2 个，满了批量还回一半
+    size_t magazine_size = 0;
+
+    // 缓冲区数上限；大于 pool_size 时池按 slab 按需扩容，0 表示固定为 pool_size
+    size_t max_pool_size = 0;
+    // 每个 slab 的缓冲区数，向上取 2 的幂；0 表示取 pool_size
+    size_t slab_size = 0;
+    // 超出初始容量的 slab 完全空闲超过该时长后释放
+    std::chrono::milliseconds shrink_cooldown{30000};
+
+    // slab 的内存来源
+    BufferStorage storage = BufferStorage::Heap;
+    // 每个缓冲区起始地址的对齐（2 的幂），0 表示紧密排列
+    // 64 可避免相邻缓冲区共享 cache line，SlabAllocator::page_size() 则按页对齐
+    // Mmap 时不能超过 SlabAllocator::page_size()
+    size_t alignment = 0;
+    // 仅 Mmap：先尝试 MAP_HUGETLB，失败则退回普通页并建议内核使用透明大页
+    bool huge_pages = false;
+    // 分配 slab 时就触发缺页（Mmap 用 MAP_POPULATE，透明大页在 madvise 之后再缺页），避免首次写入落在请求路径上
+    bool prefault = false;
+};
+
+// BufferPool::stats() 的快照，各线程的计数在读取时汇总，并发时各项之间不保证一致
+struct BufferPoolStats {
+    // 等待耗时直方图：第 0 档为无需等待（含等待不足 1us），第 k 档为 [2^(k-1), 2^k) us，最后一档为其余所有
+    static constexpr size_t wait_buckets = 22;
+
+    size_t capacity = 0;
+    size_t max_capacity = 0;
+    // 已交给使用者、尚未归还的缓冲区数
+    size_t in_use = 0;
+    // 同时离开中心位图的缓冲区数的历史最大值，每次从位图取出时更新，读取时再与 in_use 取大
+    // 开启线程缓存时也包括缓存中的空闲缓冲区，可能高于 in_use 实际达到的峰值
+    size_t high_water = 0;
+
+    uint64_t acquires = 0;
+    uint64_t releases = 0;
+    // acquire 抛异常、try_acquire 返回空、限时等待超时的次数
+    uint64_t failures = 0;
+    // 需要排队等待的成功 acquire 次数
+    uint64_t waits = 0;
+    std::array<uint64_t, wait_buckets> wait_histogram{};
+
+    double magazine_hit_ratio = 0.0;
+
+    // 第 bucket 档的上界（微秒），最后一档返回 0 表示无上界
+    static uint64_t bucket_limit_us(size_t bucket);
+    // 按直方图估计第 q 分位（0~1）的等待时间上界，单位微秒
+    [[nodiscard]] uint64_t wait_percentile_us(double q) const;
+};
+
+// 无锁空闲位图：每个缓冲区 1 bit，按 64 位字用 countr_zero 查找，可多线程共享同一个池
+// 池耗尽时：acquire 抛异常，try_acquire 返回空，
+// acquire_wait / try_acquire_for / co_await acquire_async 排队等待，归还时按 FIFO 直接交接
 class BufferPool {
+    friend class BufferSlice;
+    friend class SharedBuffer;
+
+    // 表示没有空闲缓冲区
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    // 等待者节点，放在等待方的栈上或协程帧里，不额外分配
+    struct Waiter {
+        Waiter *prev = nullptr;
+        Waiter *next = nullptr;
+        uint32_t index = npos;      // 交接到的缓冲区
+        bool ready = false;
+        // 开始等待的时间，用于等待耗时统计
+        std::chrono::steady_clock::time_point since;
+        std::condition_variable *cv = nullptr;  // 线程等待者
+        std::coroutine_handle<> handle;         // 协程等待者
+    };
+
+    // 线程本地缓存，定义见 BufferPool.cpp
+    struct Magazine;
+    struct MagazineCache;
+    // 按线程分片的统计计数，定义见 BufferPool.cpp
+    struct StatShard;
+
+    // 按 slab 记录的占用情况，只在可扩容时使用
+    struct SlabState {
+        alignas(64) std::atomic<size_t> in_use{0};
+        std::atomic<int64_t> idle_since{0};
+    };
+
     size_t buffer_size;
+    // 相邻缓冲区的间距，buffer_size 按 alignment 取整
+    size_t buffer_stride;
+    // 下标空间大小，即缓冲区数上限
     size_t pool_size;
+    size_t magazine_capacity;
+    size_t magazine_batch;
+    // 区分不同的池（地址可能被复用），用于查找线程本地缓存
+    uint64_t uid;
 
-    char *buffer;
-    bool *used;
+    // 下标 i 位于 slabs[i >> slab_shift] 的第 (i & slab_mask) 个
+    // 固定大小的池只有一个 slab，slab_shift 取 32 使任何下标都落在 slab 0
+    size_t slab_buffers;
+    unsigned slab_shift;
+    size_t slab_mask;
+    size_t min_slabs;
+    size_t max_slabs;
+    std::chrono::steady_clock::duration shrink_cooldown;
+    SlabAllocator allocator;
+    std::unique_ptr<char *[]> slabs;
+    std::unique_ptr<SlabState[]> slab_states;
+    std::atomic<size_t> slab_count;
+    // 扩容与收缩互斥
+    std::mutex grow_mtx;
+
+    // 第 i 位为 1 表示下标 i 空闲；按上限分配，只扫描已分配 slab 覆盖的字
+    std::unique_ptr<std::atomic<uint64_t>[]> free_bits;
+    size_t bitmap_words;
+    // SharedBuffer / BufferSlice 的引用计数，每个下标一个，只在共享的缓冲区上使用
+    std::unique_ptr<std::atomic<uint32_t>[]> share_counts;
+    // 下次查找的起始字，停在最近一次找到空闲位的地方
+    // 单独占一条 cache line，避免与只读成员伪共享
+    alignas(64) std::atomic<size_t> hint{0};
+
+    // 每个线程只写自己的分片，读取时汇总
+    std::unique_ptr<StatShard[]> stat_shards;
+    // 不在中心位图里的缓冲区数（使用中 + 线程缓存中）及其峰值，只在位图取出 / 放回时更新
+    alignas(64) std::atomic<size_t> outstanding{0};
+    std::atomic<size_t> peak_outstanding{0};
+
+    // 等待队列，只在池耗尽时使用
+    alignas(64) std::atomic<size_t> waiting{0};
+    std::mutex mtx;
+    Waiter *waiters_head = nullptr;
+    Waiter *waiters_tail = nullptr;
+
+    // 所有线程的本地缓存，耗尽时从中回收，统计时汇总
+    mutable std::mutex magazines_mtx;
+    std::vector<std::shared_ptr<Magazine>> magazines;
+    // 已退出线程的命中统计
+    std::atomic<uint64_t> retired_hits{0};
+    std::atomic<uint64_t> retired_misses{0};
+
+    uint32_t pop();
+    void push(uint32_t index);
+    // 批量取出 / 放回，同一个字里的多个缓冲区只需一次原子操作
+    size_t pop_batch(uint32_t *out, size_t n);
+    void push_batch(const uint32_t *indices, size_t n);
+    [[nodiscard]] size_t active_words() const;
+    // [from, to) 中第一个有空闲位的字，没有则返回 to
+    [[nodiscard]] size_t find_word(size_t from, size_t to) const;
+    // 以下只改位图，不更新占用统计
+    void set_free(size_t first, size_t count);
+    // 仅当 [first, first + count) 全部空闲时整段取走
+    bool claim_range(size_t first, size_t count);
+    // 优先走线程本地缓存
+    uint32_t take();
+    void release(uint32_t index);
+    void release_central(uint32_t index);
+    // 缓冲区进入中心位图后，交给可能存在的等待者
+    void notify_waiters();
+
+    Magazine *local_magazine();
+    // 把所有线程缓存中的缓冲区收回中心位图
+    void reclaim_magazines();
+    // 线程退出时把缓存还给池
+    static void retire(Magazine *m);
+    Buffer make_buffer(uint32_t index);
+
+    // 以下均需持有 mtx
+    void enqueue(Waiter *w);
+    void dequeue(Waiter *w);
+    // 把 index 交给队首；协程等待者挂到 resume 链上，解锁后再恢复
+    Waiter *wake_front(uint32_t index, Waiter *resume);
+    // 把位图中的空闲缓冲区依次交给队首
+    Waiter *drain(Waiter *resume);
+    // 登记等待者；登记时已拿到缓冲区则返回 false
+    bool park(Waiter *w, std::coroutine_handle<> handle);
+
+    static void resume_all(Waiter *resume);
+
+    StatShard &local_stats();
+    // 成功的 acquire 都经过 make_buffer 计数；等待过的再记录耗时
+    void record_wait(std::chrono::steady_clock::time_point since);
+    void record_failure();
+
+    void taken_from_central(const uint32_t *indices, size_t n);
+    void returned_to_central(const uint32_t *indices, size_t n);
+
+    // 共享引用计数：adopt 从 Buffer 转入时置 1，drop 减到 0 时归还
+    void adopt(uint32_t index);
+    void retain(uint32_t index);
+    void drop(uint32_t index);
+    [[nodiscard]] size_t share_count(uint32_t index) const;
+
+    [[nodiscard]] char *address(uint32_t index) const;
+    // 新增一个 slab，返回其中一个缓冲区；已达上限返回 npos
+    uint32_t grow();
+    // 释放末尾空闲超时的 slab，需持有 grow_mtx
+    size_t shrink_locked();
 public:
-    BufferPool(size_t buffer_size, size_t pool_size);
+    BufferPool(size_t buffer_size, size_t pool_size, const BufferPoolOptions &options = {});
     ~BufferPool() noexcept;
 
     BufferPool(const BufferPool &) = delete;
@@ -42,5 +246,49 @@ public:
     static void callback(size_t buffer_id, void *p);
 
     Buffer acquire();
+    std::optional<Buffer> try_acquire();
+
+    // 阻塞直到有缓冲区可用
+    Buffer acquire_wait();
+
+    std::optional<Buffer> try_acquire_until(std::chrono::steady_clock::time_point deadline);
+
+    template<class Rep, class Period>
+    std::optional<Buffer> try_acquire_for(const std::chrono::duration<Rep, Period> &timeout) {
+        return try_acquire_until(std::chrono::steady_clock::now() +
+            std::chrono::ceil<std::chrono::steady_clock::duration>(timeout));
+    }
+
+    // co_await pool.acquire_async() 得到 Buffer
+    // 协程在归还缓冲区的线程上被恢复
+    class AcquireAwaiter {
+        BufferPool *pool;
+        Waiter waiter;
+    public:
+        explicit AcquireAwaiter(BufferPool *pool) : pool{pool} {}
+
+        bool await_ready();
+        bool await_suspend(std::coroutine_handle<> handle);
+        Buffer await_resume();
+    };
+
+    AcquireAwaiter acquire_async();
+
+    [[nodiscard]] size_t buffer_bytes() const;
+    // 当前已分配的缓冲区数
+    [[nodiscard]] size_t capacity() const;
+    [[nodiscard]] size_t max_capacity() const;
+    // 立即回收线程缓存并释放空闲超时的 slab，返回释放的 slab 数
+    // 归还缓冲区时也会顺带检查，但长时间无人归还时需要定期调用
+    size_t trim();
+    // 已交给使用者、尚未归还的缓冲区数（不含线程缓存中的空闲缓冲区）
+    [[nodiscard]] size_t in_use() const;
+    [[nodiscard]] size_t high_water() const;
+    [[nodiscard]] BufferPoolStats stats() const;
+    [[nodiscard]] size_t huge_page_slabs() const;
+
+    [[nodiscard]] size_t magazine_size() const;
+    // 不经过中心位图完成的 acquire / 归还所占比例
+    [[nodiscard]] double magazine_hit_ratio() const;
 };
-#endif DAY1_BUFFERPOOL_H
\ No newline at end of file
+#endif //DAY1_BUFFERPOOL_H
@@ -0,0 +1,227 @@
+//
+// Created by Ayr on 2025/12/22.
+//
+
+#ifndef DAY1_BUFFERQUEUE_H
+#define DAY1_BUFFERQUEUE_H
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <utility>
+#include "BufferPool.h"
+
+// 在线程间传递 Buffer 这类只能移动的句柄的有界无锁环形队列
+// 容量向上取 2 的幂；每个槽位独占一条 cache line，相邻槽位的读写互不干扰
+// 满 / 空时 try_* 立即返回，不阻塞；push 失败时不会移走参数
+
+// 单生产者单消费者
+template<class T>
+class SpscQueue {
+    struct alignas(64) Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T *get() {
+            return std::launder(reinterpret_cast<T *>(storage));
+        }
+    };
+
+    size_t mask;
+    Slot *slots;
+
+    // 生产者独占的一行：写游标 + 上次看到的读游标
+    alignas(64) std::atomic<size_t> tail{0};
+    size_t cached_head = 0;
+    // 消费者独占的一行
+    alignas(64) std::atomic<size_t> head{0};
+    size_t cached_tail = 0;
+
+    // 可写槽位数，缓存不够时才去读对方的游标
+    size_t writable(size_t t, size_t want) {
+        size_t capacity = mask + 1;
+        if (capacity - (t - cached_head) < want) cached_head = head.load(std::memory_order_acquire);
+        return capacity - (t - cached_head);
+    }
+    size_t readable(size_t h, size_t want) {
+        if (cached_tail - h < want) cached_tail = tail.load(std::memory_order_acquire);
+        return cached_tail - h;
+    }
+public:
+    explicit SpscQueue(size_t capacity)
+        :mask{std::bit_ceil(std::max<size_t>(capacity, 1)) - 1}, slots{new Slot[mask + 1]} {}
+
+    ~SpscQueue() noexcept {
+        size_t t = tail.load(std::memory_order_relaxed);
+        for (size_t h = head.load(std::memory_order_relaxed); h != t; h++) slots[h & mask].get()->~T();
+        delete[] slots;
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    bool try_push(T &&value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (!writable(t, 1)) return false;
+        ::new(slots[t & mask].storage) T(std::move(value));
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::optional<T> try_pop() {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (!readable(h, 1)) return std::nullopt;
+        T *p = slots[h & mask].get();
+        std::optional<T> result{std::move(*p)};
+        p->~T();
+        head.store(h + 1, std::memory_order_release);
+        return result;
+    }
+
+    // 从 first 起移入至多 n 个，只发布一次游标；返回实际移入的个数
+    template<class It>
+    size_t try_push_batch(It first, size_t n) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        n = std::min(n, writable(t, n));
+        for (size_t i = 0; i < n; i++, ++first) ::new(slots[(t + i) & mask].storage) T(std::move(*first));
+        if (n) tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    // 至多取出 n 个写到 out（如 std::back_inserter），返回实际取出的个数
+    template<class OutputIt>
+    size_t try_pop_batch(OutputIt out, size_t n) {
+        size_t h = head.load(std::memory_order_relaxed);
+        n = std::min(n, readable(h, n));
+        for (size_t i = 0; i < n; i++) {
+            T *p = slots[(h + i) & mask].get();
+            *out++ = std::move(*p);
+            p->~T();
+        }
+        if (n) head.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+    [[nodiscard]] size_t capacity() const {
+        return mask + 1;
+    }
+    // 并发时只是近似值
+    [[nodiscard]] size_t size() const {
+        return tail.load(std::memory_order_relaxed) - head.load(std::memory_order_relaxed);
+    }
+};
+
+// 多生产者多消费者（Vyukov 有界队列）
+// 槽位的序号表示状态：等于 pos 可写，等于 pos + 1 可读，读完后推进到 pos + capacity
+template<class T>
+class MpmcQueue {
+    struct alignas(64) Slot {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T *get() {
+            return std::launder(reinterpret_cast<T *>(storage));
+        }
+    };
+
+    size_t mask;
+    Slot *slots;
+
+    alignas(64) std::atomic<size_t> tail{0};
+    alignas(64) std::atomic<size_t> head{0};
+
+    // 从 pos 起连续 n 个槽位中处于 offset 状态（0 可写，1 可读）的个数
+    size_t ready(size_t pos, size_t n, size_t offset) {
+        size_t k = 0;
+        while (k < n && slots[(pos + k) & mask].sequence.load(std::memory_order_acquire) == pos + k + offset) k++;
+        return k;
+    }
+
+    // 认领 [pos, pos + k)，返回起点；没有可用槽位时 k 为 0
+    std::pair<size_t, size_t> claim(std::atomic<size_t> &cursor, size_t n, size_t offset) {
+        size_t pos = cursor.load(std::memory_order_relaxed);
+        while (true) {
+            size_t k = ready(pos, n, offset);
+            if (!k) {
+                // 槽位仍是上一圈的状态：队列满（生产者）或空（消费者）；否则游标已被别人推进
+                auto seq = static_cast<std::ptrdiff_t>(slots[pos & mask].sequence.load(std::memory_order_acquire));
+                if (seq - static_cast<std::ptrdiff_t>(pos + offset) < 0) return {pos, 0};
+                pos = cursor.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (cursor.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed)) return {pos, k};
+        }
+    }
+public:
+    explicit MpmcQueue(size_t capacity)
+        :mask{std::bit_ceil(std::max<size_t>(capacity, 2)) - 1}, slots{new Slot[mask + 1]} {
+        for (size_t i = 0; i <= mask; i++) slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    ~MpmcQueue() noexcept {
+        size_t t = tail.load(std::memory_order_relaxed);
+        for (size_t h = head.load(std::memory_order_relaxed); h != t; h++) slots[h & mask].get()->~T();
+        delete[] slots;
+    }
+
+    MpmcQueue(const MpmcQueue &) = delete;
+    MpmcQueue &operator=(const MpmcQueue &) = delete;
+
+    bool try_push(T &&value) {
+        return try_push_batch(&value, 1) == 1;
+    }
+
+    std::optional<T> try_pop() {
+        std::optional<T> result;
+        struct Out {
+            std::optional<T> *result;
+            Out &operator*() { return *this; }
+            Out &operator++(int) { return *this; }
+            Out &operator=(T &&value) {
+                result->emplace(std::move(value));
+                return *this;
+            }
+        };
+        try_pop_batch(Out{&result}, 1);
+        return result;
+    }
+
+    // 一次 CAS 认领连续的多个槽位
+    template<class It>
+    size_t try_push_batch(It first, size_t n) {
+        auto [pos, k] = claim(tail, n, 0);
+        for (size_t i = 0; i < k; i++, ++first) {
+            Slot &slot = slots[(pos + i) & mask];
+            ::new(slot.storage) T(std::move(*first));
+            slot.sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        return k;
+    }
+
+    template<class OutputIt>
+    size_t try_pop_batch(OutputIt out, size_t n) {
+        auto [pos, k] = claim(head, n, 1);
+        for (size_t i = 0; i < k; i++) {
+            Slot &slot = slots[(pos + i) & mask];
+            T *p = slot.get();
+            *out++ = std::move(*p);
+            p->~T();
+            slot.sequence.store(pos + i + mask + 1, std::memory_order_release);
+        }
+        return k;
+    }
+
+    [[nodiscard]] size_t capacity() const {
+        return mask + 1;
+    }
+    [[nodiscard]] size_t size() const {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t h = head.load(std::memory_order_relaxed);
+        return t > h ? t - h : 0;
+    }
+};
+
+using SpscBufferQueue = SpscQueue<Buffer>;
+using MpmcBufferQueue = MpmcQueue<Buffer>;
+#endif //DAY1_BUFFERQUEUE_H
@@ -0,0 +1,120 @@
+//
+// Created by Ayr on 2025/12/21.
+//
+
+#ifndef DAY1_FIXEDBUFFERPOOL_H
+#define DAY1_FIXEDBUFFERPOOL_H
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+
+// 几何参数在编译期确定的缓冲池，存储是静态的（.bss，首次写入时才真正占用内存）
+// 同样的 <BufferSize, Count> 共用一个池，需要独立的池时换一个 Tag
+// 句柄只有一个指针（8 字节），归还是对 release 的直接调用，可以内联；
+// 对比 Buffer 的 32 字节和经函数指针的间接调用
+// 空闲管理与 BufferPool 相同：原子位图 + countr_zero，可多线程共享
+template<size_t BufferSize, size_t Count, class Tag = void>
+class FixedBufferPool {
+    static_assert(BufferSize > 0 && Count > 0);
+
+    static constexpr size_t words = (Count + 63) / 64;
+    // 最后一个字里超出 Count 的位永远不可用
+    static constexpr uint64_t last_mask = Count % 64 ? (uint64_t{1} << (Count % 64)) - 1 : ~uint64_t{0};
+
+    // 第 i 位为 1 表示下标 i 在使用中；零初始化即全部空闲
+    alignas(64) static inline std::atomic<uint64_t> used_bits[words]{};
+    // 下次查找的起始字
+    alignas(64) static inline std::atomic<size_t> hint{0};
+    alignas(64) static inline char storage[Count][BufferSize];
+
+    static constexpr uint64_t valid_bits(size_t w) {
+        return w == words - 1 ? last_mask : ~uint64_t{0};
+    }
+
+    static char *pop() {
+        size_t start = hint.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < words; i++) {
+            size_t w = start + i < words ? start + i : start + i - words;
+            uint64_t bits = used_bits[w].load(std::memory_order_relaxed);
+            while (uint64_t free = ~bits & valid_bits(w)) {
+                uint64_t bit = free & (~free + 1);
+                if (used_bits[w].compare_exchange_weak(bits, bits | bit,
+                                                       std::memory_order_acquire, std::memory_order_relaxed)) {
+                    if (w != start) hint.store(w, std::memory_order_relaxed);
+                    return storage[w * 64 + std::countr_zero(bit)];
+                }
+            }
+        }
+        return nullptr;
+    }
+public:
+    static constexpr size_t buffer_size = BufferSize;
+    static constexpr size_t pool_size = Count;
+
+    class Handle {
+        char *ptr = nullptr;
+
+        friend class FixedBufferPool;
+        explicit Handle(char *ptr) : ptr{ptr} {}
+    public:
+        Handle() = default;
+        ~Handle() noexcept {
+            if (ptr) FixedBufferPool::release(ptr);
+        }
+
+        Handle(const Handle &) = delete;
+        Handle(Handle &&other) noexcept : ptr{other.ptr} {
+            other.ptr = nullptr;
+        }
+
+        Handle &operator=(const Handle &) = delete;
+        Handle &operator=(Handle &&other) noexcept {
+            if (this == &other) return *this;
+            if (ptr) FixedBufferPool::release(ptr);
+            ptr = other.ptr;
+            other.ptr = nullptr;
+            return *this;
+        }
+
+        [[nodiscard]] char *data() const {
+            return ptr;
+        }
+        [[nodiscard]] static constexpr size_t size() {
+            return BufferSize;
+        }
+        explicit operator bool() const {
+            return ptr != nullptr;
+        }
+    };
+    static_assert(sizeof(Handle) == sizeof(char *));
+
+    FixedBufferPool() = delete;
+
+    static Handle acquire() {
+        char *p = pop();
+        if (!p) throw std::runtime_error{"Cannot find a free space"};
+        return Handle{p};
+    }
+
+    static std::optional<Handle> try_acquire() {
+        char *p = pop();
+        if (!p) return std::nullopt;
+        return Handle{p};
+    }
+
+    // 由 Handle 析构调用，除法在 BufferSize 为 2 的幂时编译成移位
+    static void release(char *p) noexcept {
+        size_t index = static_cast<size_t>(p - storage[0]) / BufferSize;
+        used_bits[index / 64].fetch_and(~(uint64_t{1} << (index % 64)), std::memory_order_release);
+    }
+
+    [[nodiscard]] static size_t in_use() {
+        size_t n = 0;
+        for (auto &w : used_bits) n += std::popcount(w.load(std::memory_order_relaxed));
+        return n;
+    }
+};
+#endif //DAY1_FIXEDBUFFERPOOL_H
@@ -0,0 +1,175 @@
+//
+// Created by Ayr on 2025/12/22.
+//
+#include "PrefetchReader.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <system_error>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+PrefetchReader::PrefetchReader(BufferPool &pool, const std::string &path, size_t depth, size_t threads)
+    :pool{&pool}, chunk_size{pool.buffer_bytes()}, depth{std::max<size_t>(depth, 1)} {
+    if (chunk_size == 0) throw std::invalid_argument{"Buffer size must be positive"};
+    if (threads == 0) throw std::invalid_argument{"At least one reader thread is required"};
+
+#ifdef _WIN32
+    handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                         FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        throw std::system_error{static_cast<int>(GetLastError()), std::system_category(), "Cannot open " + path};
+    }
+    LARGE_INTEGER length;
+    if (!GetFileSizeEx(handle, &length)) {
+        auto code = static_cast<int>(GetLastError());
+        close_file();
+        throw std::system_error{code, std::system_category(), "Cannot stat " + path};
+    }
+    file_size = static_cast<size_t>(length.QuadPart);
+#else
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) throw std::system_error{errno, std::generic_category(), "Cannot open " + path};
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        int code = errno;
+        close_file();
+        throw std::system_error{code, std::generic_category(), "Cannot stat " + path};
+    }
+    file_size = static_cast<size_t>(st.st_size);
+#ifdef POSIX_FADV_SEQUENTIAL
+    // 让内核把预读窗口开大
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+#endif
+    total_chunks = (file_size + chunk_size - 1) / chunk_size;
+    try {
+        ready.resize(this->depth);
+        for (size_t i = 0; i < threads; i++) workers.emplace_back(&PrefetchReader::work, this);
+    } catch (...) {
+        // 析构函数不会运行，已启动的读线程要在这里收回
+        stop();
+        close_file();
+        throw;
+    }
+}
+
+PrefetchReader::~PrefetchReader() noexcept {
+    stop();
+    // 未交付的块随 ready 一起析构，缓冲区回到池中
+    close_file();
+}
+
+void PrefetchReader::stop() noexcept {
+    {
+        std::lock_guard lock(mtx);
+        stopping = true;
+        space_cv.notify_all();
+    }
+    for (auto &worker : workers) worker.join();
+}
+
+void PrefetchReader::close_file() noexcept {
+#ifdef _WIN32
+    CloseHandle(handle);
+#else
+    ::close(fd);
+#endif
+}
+
+size_t PrefetchReader::read_at(char *out, size_t offset, size_t size) const {
+    size_t done = 0;
+    while (done < size) {
+#ifdef _WIN32
+        OVERLAPPED position{};
+        position.Offset = static_cast<DWORD>(offset + done);
+        position.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset + done) >> 32);
+        DWORD n = 0;
+        DWORD want = static_cast<DWORD>(std::min<size_t>(size - done, 1u << 30));
+        if (!ReadFile(handle, out + done, want, &n, &position)) {
+            auto code = GetLastError();
+            if (code == ERROR_HANDLE_EOF) break;
+            throw std::system_error{static_cast<int>(code), std::system_category(), "ReadFile failed"};
+        }
+#else
+        ssize_t n = ::pread(fd, out + done, size - done, static_cast<off_t>(offset + done));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::system_error{errno, std::generic_category(), "pread failed"};
+        }
+#endif
+        if (n == 0) break;
+        done += static_cast<size_t>(n);
+    }
+    return done;
+}
+
+void PrefetchReader::work() {
+    using namespace std::chrono_literals;
+    while (true) {
+        size_t seq;
+        {
+            std::unique_lock lock(mtx);
+            space_cv.wait(lock, [this] {
+                return stopping || next_seq == total_chunks || next_seq - consumed < depth;
+            });
+            if (stopping || next_seq == total_chunks) return;
+            seq = next_seq++;
+        }
+
+        size_t offset = seq * chunk_size;
+        size_t size = std::min(chunk_size, file_size - offset);
+        std::optional<Buffer> buffer;
+        try {
+            // 池被别处占满时不无限等待，以便析构时能退出
+            while (!(buffer = pool->try_acquire_for(10ms))) {
+                std::lock_guard lock(mtx);
+                if (stopping) return;
+            }
+            if (read_at(buffer->data(), offset, size) != size) {
+                throw std::runtime_error{"File was truncated while reading"};
+            }
+        } catch (...) {
+            std::lock_guard lock(mtx);
+            if (!error) error = std::current_exception();
+            stopping = true;
+            space_cv.notify_all();
+            ready_cv.notify_one();
+            return;
+        }
+
+        std::lock_guard lock(mtx);
+        ready[seq % depth].emplace(Chunk{std::move(*buffer), offset, size});
+        ready_cv.notify_one();
+    }
+}
+
+std::optional<PrefetchReader::Chunk> PrefetchReader::next() {
+    std::unique_lock lock(mtx);
+    if (consumed == total_chunks) return std::nullopt;
+
+    auto &slot = ready[consumed % depth];
+    ready_cv.wait(lock, [&] { return slot.has_value() || error; });
+    if (!slot) std::rethrow_exception(error);
+
+    std::optional<Chunk> chunk{std::move(*slot)};
+    slot.reset();
+    consumed++;
+    space_cv.notify_one();
+    return chunk;
+}
+
+size_t PrefetchReader::size() const {
+    return file_size;
+}
+
+size_t PrefetchReader::chunk_count() const {
+    return total_chunks;
+}
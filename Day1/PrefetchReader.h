@@ -0,0 +1,89 @@
+//
+// Created by Ayr on 2025/12/22.
+//
+
+#ifndef DAY1_PREFETCHREADER_H
+#define DAY1_PREFETCHREADER_H
+#include "BufferPool.h"
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 预读文件读取器：后台线程用 pread 把文件按块读进池内 Buffer，
+// 同时最多 depth 块在途（已读或正在读、尚未交给消费者），消费者处理当前块时下一块已在读取
+// 块按文件顺序交付；多个读线程可以并行读不同的块（适合 NVMe 等高队列深度的设备）
+// 池中至少要有 depth 个可用缓冲区，外加消费者同时持有的块数
+class PrefetchReader {
+public:
+    struct Chunk {
+        Buffer buffer;
+        // 在文件中的起始偏移与有效字节数，只有最后一块可能不满
+        size_t offset;
+        size_t size;
+
+        [[nodiscard]] const char *data() const {
+            return buffer.data();
+        }
+    };
+private:
+    BufferPool *pool;
+    size_t chunk_size;
+    size_t depth;
+#ifdef _WIN32
+    void *handle;
+#else
+    int fd;
+#endif
+    size_t file_size;
+    size_t total_chunks;
+
+    std::mutex mtx;
+    // 读线程等待在途数降下来，消费者等待下一块读完
+    std::condition_variable space_cv;
+    std::condition_variable ready_cv;
+    // 第 seq 块放在 ready[seq % depth]
+    std::vector<std::optional<Chunk>> ready;
+    size_t next_seq = 0;
+    size_t consumed = 0;
+    bool stopping = false;
+    // 读线程遇到的第一个错误，由 next() 重新抛出
+    std::exception_ptr error;
+    std::vector<std::thread> workers;
+
+    void work();
+    // 读满 [offset, offset + size)，遇到 EOF 提前返回，出错抛 system_error
+    size_t read_at(char *out, size_t offset, size_t size) const;
+    // 通知读线程退出并等待它们结束
+    void stop() noexcept;
+    void close_file() noexcept;
+public:
+    // 打开失败抛 system_error
+    PrefetchReader(BufferPool &pool, const std::string &path, size_t depth = 4, size_t threads = 1);
+    ~PrefetchReader() noexcept;
+
+    PrefetchReader(const PrefetchReader &) = delete;
+    PrefetchReader &operator=(const PrefetchReader &) = delete;
+
+    // 阻塞等待下一块，读完返回空
+    std::optional<Chunk> next();
+
+    // 依次把每块交给 f，返回处理的总字节数
+    template<class F>
+    size_t for_each(F &&f) {
+        size_t bytes = 0;
+        while (auto chunk = next()) {
+            bytes += chunk->size;
+            f(*chunk);
+        }
+        return bytes;
+    }
+
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] size_t chunk_count() const;
+};
+#endif //DAY1_PREFETCHREADER_H
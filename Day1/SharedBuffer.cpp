@@ -0,0 +1,105 @@
+//
+// Created by Ayr on 2025/12/21.
+//
+#include "SharedBuffer.h"
+#include <stdexcept>
+#include <utility>
+
+BufferSlice::BufferSlice(BufferPool *pool, uint32_t index, char *ptr, size_t length)
+    :pool{pool}, index{index}, ptr{ptr}, length{length} {}
+
+BufferSlice::~BufferSlice() noexcept {
+    reset();
+}
+
+BufferSlice::BufferSlice(const BufferSlice &other) noexcept
+    :pool{other.pool}, index{other.index}, ptr{other.ptr}, length{other.length} {
+    if (pool) pool->retain(index);
+}
+
+BufferSlice::BufferSlice(BufferSlice &&other) noexcept
+    :pool{other.pool}, index{other.index}, ptr{other.ptr}, length{other.length} {
+    other.pool = nullptr;
+    other.ptr = nullptr;
+    other.length = 0;
+}
+
+BufferSlice &BufferSlice::operator=(const BufferSlice &other) noexcept {
+    // 先复制一份（加引用）再移入，自赋值时不会提前归还
+    BufferSlice copy{other};
+    *this = std::move(copy);
+    return *this;
+}
+
+BufferSlice &BufferSlice::operator=(BufferSlice &&other) noexcept {
+    if (this == &other) return *this;
+    reset();
+    pool = other.pool;
+    index = other.index;
+    ptr = other.ptr;
+    length = other.length;
+
+    other.pool = nullptr;
+    other.ptr = nullptr;
+    other.length = 0;
+    return *this;
+}
+
+const char *BufferSlice::data() const {
+    return ptr;
+}
+
+size_t BufferSlice::size() const {
+    return length;
+}
+
+bool BufferSlice::empty() const {
+    return length == 0;
+}
+
+BufferSlice::operator bool() const {
+    return pool != nullptr;
+}
+
+BufferSlice BufferSlice::slice(size_t offset, size_t length) const {
+    if (!pool) throw std::logic_error{"Slice of an empty BufferSlice"};
+    if (offset > this->length || length > this->length - offset) {
+        throw std::out_of_range{"Slice exceeds the buffer"};
+    }
+    pool->retain(index);
+    return BufferSlice{pool, index, ptr + offset, length};
+}
+
+size_t BufferSlice::use_count() const {
+    return pool ? pool->share_count(index) : 0;
+}
+
+void BufferSlice::reset() noexcept {
+    if (!pool) return;
+    pool->drop(index);
+    pool = nullptr;
+    ptr = nullptr;
+    length = 0;
+}
+
+// ----
+
+SharedBuffer::SharedBuffer(Buffer &&buffer) {
+    if (!buffer.callback) throw std::invalid_argument{"Buffer is empty"};
+    if (buffer.callback != &BufferPool::callback) throw std::invalid_argument{"Buffer is not from a BufferPool"};
+
+    pool = static_cast<BufferPool *>(buffer.p);
+    index = static_cast<uint32_t>(buffer.buffer_id);
+    ptr = buffer.buffer;
+    length = pool->buffer_bytes();
+    pool->adopt(index);
+
+    // 缓冲区的归还改由引用计数负责
+    buffer.callback = nullptr;
+    buffer.buffer = nullptr;
+    buffer.p = nullptr;
+}
+
+char *SharedBuffer::data() const {
+    return ptr;
+}
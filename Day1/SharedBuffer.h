@@ -0,0 +1,55 @@
+//
+// Created by Ayr on 2025/12/21.
+//
+
+#ifndef DAY1_SHAREDBUFFER_H
+#define DAY1_SHAREDBUFFER_H
+#include "BufferPool.h"
+#include <cstddef>
+#include <cstdint>
+
+// 池内缓冲区某一段的共享只读视图
+// 引用计数放在池的元数据里（每个缓冲区一个原子计数），视图本身不额外分配
+// 最后一个视图析构时缓冲区才回到 BufferPool，可把同一份数据零拷贝地分发给多个消费者
+class BufferSlice {
+protected:
+    BufferPool *pool = nullptr;
+    uint32_t index = 0;
+    char *ptr = nullptr;
+    size_t length = 0;
+
+    // 接管一次已计入的引用
+    BufferSlice(BufferPool *pool, uint32_t index, char *ptr, size_t length);
+public:
+    BufferSlice() = default;
+    ~BufferSlice() noexcept;
+
+    BufferSlice(const BufferSlice &other) noexcept;
+    BufferSlice(BufferSlice &&other) noexcept;
+
+    BufferSlice &operator=(const BufferSlice &other) noexcept;
+    BufferSlice &operator=(BufferSlice &&other) noexcept;
+
+    [[nodiscard]] const char *data() const;
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] bool empty() const;
+    explicit operator bool() const;
+
+    // [offset, offset + length) 的子视图，与本视图共享同一个缓冲区；越界抛 out_of_range
+    [[nodiscard]] BufferSlice slice(size_t offset, size_t length) const;
+    // 当前指向同一缓冲区的视图数
+    [[nodiscard]] size_t use_count() const;
+    void reset() noexcept;
+};
+
+// 整个缓冲区的共享句柄，由独占的 Buffer 转换而来
+// 生产者通过它写入数据，再用 slice() 分发只读视图
+class SharedBuffer : public BufferSlice {
+public:
+    SharedBuffer() = default;
+    // 只接受 BufferPool 分配的 Buffer，否则抛 invalid_argument；转换后 buffer 不再持有缓冲区
+    explicit SharedBuffer(Buffer &&buffer);
+
+    [[nodiscard]] char *data() const;
+};
+#endif //DAY1_SHAREDBUFFER_H
@@ -0,0 +1,155 @@
+//
+// Created by Ayr on 2025/12/21.
+//
+#include "SlabAllocator.h"
+#include <new>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    size_t round_up(size_t n, size_t unit) {
+        return (n + unit - 1) / unit * unit;
+    }
+
+    // 每页写一个字节，把缺页提前到分配时
+    void touch_pages(char *p, size_t bytes) {
+        size_t page = SlabAllocator::page_size();
+        for (size_t offset = 0; offset < bytes; offset += page) {
+            static_cast<volatile char *>(p)[offset] = 0;
+        }
+    }
+}
+
+SlabAllocator::SlabAllocator(BufferStorage storage, size_t alignment, bool huge_pages, bool prefault)
+    :storage{storage}, alignment{std::max(alignment, alignof(std::max_align_t))},
+     huge_pages{huge_pages}, prefault{prefault} {
+    if (alignment & (alignment - 1)) throw std::invalid_argument{"Alignment must be a power of two"};
+    // 映射只保证按页对齐
+    if (storage == BufferStorage::Mmap && alignment > page_size()) {
+        throw std::invalid_argument{"Mmap alignment cannot exceed the page size"};
+    }
+}
+
+size_t SlabAllocator::page_size() {
+#ifdef _WIN32
+    static const size_t size = [] {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwPageSize);
+    }();
+#else
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    return size;
+}
+
+size_t SlabAllocator::huge_page_size() {
+#ifdef _WIN32
+    static const size_t size = GetLargePageMinimum() ? GetLargePageMinimum() : 2 * 1024 * 1024;
+#else
+    // x86-64 / arm64 默认的大页大小
+    static const size_t size = 2 * 1024 * 1024;
+#endif
+    return size;
+}
+
+size_t SlabAllocator::mapped_length(size_t bytes) const {
+    return round_up(std::max<size_t>(bytes, 1), huge_pages ? huge_page_size() : page_size());
+}
+
+char *SlabAllocator::allocate(size_t bytes) {
+    if (storage == BufferStorage::Heap) {
+        auto *p = static_cast<char *>(::operator new(std::max<size_t>(bytes, 1), std::align_val_t(alignment)));
+        if (prefault) touch_pages(p, bytes);
+        return p;
+    }
+
+    size_t length = mapped_length(bytes);
+#ifdef _WIN32
+    void *p = nullptr;
+    if (huge_pages) {
+        // 需要 SeLockMemoryPrivilege，没有权限时退回普通页
+        p = VirtualAlloc(nullptr, length, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (p) huge_slabs.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (!p) {
+        p = VirtualAlloc(nullptr, length, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (!p) throw std::bad_alloc{};
+        if (prefault) touch_pages(static_cast<char *>(p), length);
+    }
+    return static_cast<char *>(p);
+#else
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    // 按最终页大小直接建立映射时才能用 MAP_POPULATE
+    int populate = 0;
+#ifdef MAP_POPULATE
+    if (prefault) populate = MAP_POPULATE;
+#endif
+    void *p;
+#ifdef MAP_HUGETLB
+    if (huge_pages) {
+        // 需要预留 hugetlbfs 页（vm.nr_hugepages），否则失败
+        p = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB | populate, -1, 0);
+        if (p != MAP_FAILED) {
+            huge_slabs.fetch_add(1, std::memory_order_relaxed);
+            if (prefault && !populate) touch_pages(static_cast<char *>(p), length);
+            return static_cast<char *>(p);
+        }
+    }
+#endif
+    if (!huge_pages) {
+        p = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags | populate, -1, 0);
+        if (p == MAP_FAILED) throw std::bad_alloc{};
+        if (prefault && !populate) touch_pages(static_cast<char *>(p), length);
+        return static_cast<char *>(p);
+    }
+
+    // 退而求其次：透明大页。多映射一个大页再裁掉两端，使起始地址按大页对齐，
+    // 否则首尾不满一个大页的部分无法由大页承载
+    size_t huge = huge_page_size();
+    p = mmap(nullptr, length + huge, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (p == MAP_FAILED) throw std::bad_alloc{};
+    auto *raw = static_cast<char *>(p);
+    auto *base = reinterpret_cast<char *>(round_up(reinterpret_cast<uintptr_t>(raw), huge));
+    size_t head = static_cast<size_t>(base - raw);
+    if (head) munmap(raw, head);
+    if (huge - head) munmap(base + length, huge - head);
+#ifdef MADV_HUGEPAGE
+    madvise(base, length, MADV_HUGEPAGE);
+#endif
+    // 缺页必须在 madvise 之后触发，MAP_POPULATE 会先按 4 KiB 页建好映射
+    if (prefault) {
+#ifdef MADV_POPULATE_WRITE
+        if (madvise(base, length, MADV_POPULATE_WRITE) != 0)
+#endif
+            touch_pages(base, length);
+    }
+    return base;
+#endif
+}
+
+void SlabAllocator::deallocate(char *p, size_t bytes) noexcept {
+    if (!p) return;
+    if (storage == BufferStorage::Heap) {
+        ::operator delete(p, std::align_val_t(alignment));
+        return;
+    }
+#ifdef _WIN32
+    (void)bytes;
+    VirtualFree(p, 0, MEM_RELEASE);
+#else
+    munmap(p, mapped_length(bytes));
+#endif
+}
+
+size_t SlabAllocator::huge_page_slabs() const {
+    return huge_slabs.load(std::memory_order_relaxed);
+}
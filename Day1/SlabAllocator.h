@@ -0,0 +1,40 @@
+//
+// Created by Ayr on 2025/12/21.
+//
+
+#ifndef DAY1_SLABALLOCATOR_H
+#define DAY1_SLABALLOCATOR_H
+#include <cstddef>
+#include <atomic>
+
+enum class BufferStorage {
+    Heap,   // operator new，按 alignment 对齐
+    Mmap    // 匿名映射，页对齐，可用大页
+};
+
+// BufferPool 的底层内存来源，每次分配 / 释放一整个 slab
+class SlabAllocator {
+    BufferStorage storage;
+    size_t alignment;
+    bool huge_pages;
+    bool prefault;
+    std::atomic<size_t> huge_slabs{0};
+
+    // 映射长度按页（或大页）取整，释放时按同样规则计算
+    [[nodiscard]] size_t mapped_length(size_t bytes) const;
+public:
+    SlabAllocator(BufferStorage storage, size_t alignment, bool huge_pages, bool prefault);
+
+    SlabAllocator(const SlabAllocator &) = delete;
+    SlabAllocator &operator=(const SlabAllocator &) = delete;
+
+    [[nodiscard]] char *allocate(size_t bytes);
+    void deallocate(char *p, size_t bytes) noexcept;
+
+    // 成功使用显式大页（MAP_HUGETLB / MEM_LARGE_PAGES）的 slab 数
+    [[nodiscard]] size_t huge_page_slabs() const;
+
+    static size_t page_size();
+    static size_t huge_page_size();
+};
+#endif //DAY1_SLABALLOCATOR_H
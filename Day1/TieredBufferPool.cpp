@@ -0,0 +1,77 @@
+//
+// Created by Ayr on 2025/12/20.
+//
+#include "TieredBufferPool.h"
+#include <algorithm>
+#include <stdexcept>
+
+TieredBufferPool::TieredBufferPool(std::vector<TierConfig> configs, const BufferPoolOptions &options) {
+    if (configs.empty()) throw std::invalid_argument{"At least one tier is required"};
+
+    std::sort(configs.begin(), configs.end(),
+              [](const TierConfig &a, const TierConfig &b) { return a.buffer_size < b.buffer_size; });
+    for (auto &config : configs) {
+        tiers.push_back(std::make_unique<Tier>(config, options));
+    }
+}
+
+std::vector<TierConfig> TieredBufferPool::power_of_two_tiers(size_t min_size, size_t max_size, size_t pool_size) {
+    std::vector<TierConfig> configs;
+    for (size_t size = min_size; size && size <= max_size; size *= 2) {
+        configs.push_back({size, pool_size});
+    }
+    return configs;
+}
+
+size_t TieredBufferPool::tier_of(size_t bytes) const {
+    // 档位通常不超过十几个，线性查找即可
+    size_t i = 0;
+    while (i < tiers.size() && tiers[i]->pool.buffer_bytes() < bytes) i++;
+    return i;
+}
+
+std::optional<Buffer> TieredBufferPool::try_acquire(size_t bytes) {
+    size_t first = tier_of(bytes);
+    if (first == tiers.size()) return std::nullopt;
+
+    Tier &requested = *tiers[first];
+    requested.requests.fetch_add(1, std::memory_order_relaxed);
+    for (size_t i = first; i < tiers.size(); i++) {
+        if (auto buf = tiers[i]->pool.try_acquire()) {
+            if (i != first) requested.spills.fetch_add(1, std::memory_order_relaxed);
+            return buf;
+        }
+    }
+    requested.failures.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+}
+
+Buffer TieredBufferPool::acquire(size_t bytes) {
+    if (tier_of(bytes) == tiers.size()) throw std::length_error{"Requested size exceeds the largest tier"};
+
+    auto buf = try_acquire(bytes);
+    if (!buf) throw std::runtime_error{"Cannot find a free space"};
+    return std::move(*buf);
+}
+
+size_t TieredBufferPool::size_class(size_t bytes) const {
+    size_t i = tier_of(bytes);
+    return i == tiers.size() ? 0 : tiers[i]->pool.buffer_bytes();
+}
+
+std::vector<TierStats> TieredBufferPool::stats() const {
+    std::vector<TierStats> result;
+    result.reserve(tiers.size());
+    for (auto &tier : tiers) {
+        result.push_back({
+            tier->pool.buffer_bytes(),
+            tier->pool.capacity(),
+            tier->pool.in_use(),
+            tier->pool.high_water(),
+            tier->requests.load(std::memory_order_relaxed),
+            tier->spills.load(std::memory_order_relaxed),
+            tier->failures.load(std::memory_order_relaxed)
+        });
+    }
+    return result;
+}
@@ -0,0 +1,64 @@
+//
+// Created by Ayr on 2025/12/20.
+//
+
+#ifndef DAY1_TIEREDBUFFERPOOL_H
+#define DAY1_TIEREDBUFFERPOOL_H
+#include "BufferPool.h"
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+
+struct TierConfig {
+    size_t buffer_size;
+    size_t pool_size;
+};
+
+struct TierStats {
+    size_t buffer_size;
+    size_t capacity;
+    size_t in_use;
+    size_t high_water;
+    uint64_t requests;  // 按大小落在本档的请求数
+    uint64_t spills;    // 本档耗尽、由更大档位满足的请求数
+    uint64_t failures;  // 本档及更大档位全部耗尽的请求数
+};
+
+// 多档位缓冲池：acquire(bytes) 返回能装下 bytes 的最小档位的 Buffer
+// 该档耗尽时依次向更大的档位借用
+class TieredBufferPool {
+    struct Tier {
+        BufferPool pool;
+        alignas(64) std::atomic<uint64_t> requests{0};
+        std::atomic<uint64_t> spills{0};
+        std::atomic<uint64_t> failures{0};
+
+        Tier(const TierConfig &config, const BufferPoolOptions &options)
+            : pool{config.buffer_size, config.pool_size, options} {}
+    };
+
+    // 按 buffer_size 升序
+    std::vector<std::unique_ptr<Tier>> tiers;
+
+    // 返回第一个 buffer_size >= bytes 的档位下标，没有则返回 tiers.size()
+    [[nodiscard]] size_t tier_of(size_t bytes) const;
+public:
+    explicit TieredBufferPool(std::vector<TierConfig> configs, const BufferPoolOptions &options = {});
+
+    // 从 min_size 到 max_size 按 2 倍递增的档位，每档 pool_size 个
+    static std::vector<TierConfig> power_of_two_tiers(size_t min_size, size_t max_size, size_t pool_size);
+
+    TieredBufferPool(const TieredBufferPool &) = delete;
+    TieredBufferPool &operator=(const TieredBufferPool &) = delete;
+
+    Buffer acquire(size_t bytes);
+    std::optional<Buffer> try_acquire(size_t bytes);
+
+    // bytes 对应的档位大小，超出最大档位返回 0
+    [[nodiscard]] size_t size_class(size_t bytes) const;
+    [[nodiscard]] std::vector<TierStats> stats() const;
+};
+#endif //DAY1_TIEREDBUFFERPOOL_H
@@ -9,12 +9,33 @@
 #include <cstring>
 #include <cassert>
 #include <stdexcept>
+#include <atomic>
+#include <algorithm>
+#include <coroutine>
+#include <optional>
 
 using namespace std;
 using namespace std::chrono;
 
 // ===== 你的实现 =====
 #include "BufferPool.h"
+#include "TieredBufferPool.h"
+#include "BufferChain.h"
+#include "SharedBuffer.h"
+#include "FixedBufferPool.h"
+#include "BufferQueue.h"
+#include "PrefetchReader.h"
+#include <filesystem>
+#include <fstream>
+#include <queue>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 // ===== 原始题目测试用例 =====
 
 void test_case_1() {
@@ -264,6 +285,1083 @@ void test_case_10() {
     }
 }
 
+void test_case_11() {
+    cout << "Test 11: 多线程并发获取归还 - ";
+    try {
+        constexpr int thread_count = 8;
+        constexpr int rounds = 20000;
+        BufferPool pool(64, thread_count);
+        atomic<bool> corrupted{false};
+
+        vector<thread> threads;
+        for (int t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&pool, &corrupted, t]() {
+                for (int i = 0; i < rounds; ++i) {
+                    // 每个线程最多持有一个，池大小等于线程数，不应耗尽
+                    auto buf = pool.acquire();
+                    memset(buf.data(), 'a' + t, 64);
+                    this_thread::yield();
+                    // 同一个缓冲区被发给两个线程时内容会被覆盖
+                    if (buf.data()[0] != 'a' + t || buf.data()[63] != 'a' + t) corrupted = true;
+                }
+            });
+        }
+        for (auto& th : threads) th.join();
+
+        assert(!corrupted && "A buffer was handed out twice");
+        vector<Buffer> buffers;
+        for (int i = 0; i < thread_count; ++i) {
+            buffers.push_back(pool.acquire());
+        }
+
+        cout << "✅ PASSED" << endl;
+    } catch (const exception& e) {
+        cout << "❌ FAILED: " << e.what() << endl;
+    }
+}
+
+void test_case_12() {
+    cout << "Test 12: 多线程竞争性能 - " << endl;
+    try {
+        constexpr int ops_per_thread = 200000;
+        unsigned max_threads = max(32u, thread::hardware_concurrency());
+
+        for (unsigned thread_count = 1; thread_count <= max_threads; thread_count *= 2) {
+            BufferPool pool(1024, thread_count * 4);
+
+            vector<thread> threads;
+            auto start = high_resolution_clock::now();
+            for (unsigned t = 0; t < thread_count; ++t) {
+                threads.emplace_back([&pool]() {
+                    for (int i = 0; i < ops_per_thread; ++i) {
+                        auto buf = pool.acquire();
+                        buf.data()[0] = 0;
+                    }
+                });
+            }
+            for (auto& th : threads) th.join();
+            auto end = high_resolution_clock::now();
+
+            double seconds = duration<double>(end - start).count();
+            cout << "  " << thread_count << " threads: "
+                 << static_cast<long long>(thread_count * ops_per_thread / seconds) << " acquires/s" << endl;
+        }
+        cout << "  ✅ PASSED" << endl;
+    } catch (const exception& e) {
+        cout << "❌ FAILED: " << e.what() << endl;
+    }
+}
+
+void test_case_13() {
+    cout << "Test 13: 阻塞与限时获取 - ";
+    try {
+        BufferPool pool(1024, 1);
+        optional<Buffer> held = pool.acquire();
+
+        // 限时获取：超时返回空，不抛异常
+        auto timed_out = pool.try_acquire_for(milliseconds(20));
+        assert(!timed_out && "try_acquire_for should time out on an exhausted pool");
+        assert(!pool.try_acquire() && "try_acquire should fail on an exhausted pool");
+
+        // 阻塞获取：另一线程归还后被唤醒，拿到的正是归还的缓冲区
+        char* held_ptr = held->data();
+        thread releaser([&held]() {
+            this_thread::sleep_for(milliseconds(20));
+            held.reset();
+        });
+        optional<Buffer> buf = pool.acquire_wait();
+        releaser.join();
+        assert(buf->data() == held_ptr && "acquire_wait should receive the released buffer");
+
+        thread releaser2([&buf]() {
+            this_thread::sleep_for(milliseconds(20));
+            buf.reset();
+        });
+        auto timed = pool.try_acquire_for(seconds(5));
+        releaser2.join();
+        assert(timed && timed->data() == held_ptr && "try_acquire_for should be woken by release");
+
+        cout << "✅ PASSED" << endl;
+    } catch (const exception& e) {
+        cout << "❌ FAILED: " << e.what() << endl;
+    }
+}
+
+// 最简单的协程类型：立即开始，结束时不挂起
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() { return {}; }
+        suspend_never initial_suspend() noexcept { return {}; }
+        suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { terminate(); }
+    };
+};
+
+DetachedTask acquire_and_record(BufferPool& pool, vector<int>& order, vector<Buffer>& sink, int id) {
+    auto buf = co_await pool.acquire_async();
+    order.push_back(id);
+    sink.push_back(std::move(buf));
+}
+
+void test_case_14() {
+    cout << "Test 14: 协程等待按 FIFO 交接 - ";
+    try {
+        BufferPool pool(1024, 3);
+        vector<Buffer> held;
+        for (int i = 0; i < 3; ++i) held.push_back(pool.acquire());
+
+        vector<int> order;
+        vector<Buffer> sink;
+        sink.reserve(3);
+        for (int id = 0; id < 3; ++id) acquire_and_record(pool, order, sink, id);
+        assert(order.empty() && "Coroutines should be suspended while the pool is exhausted");
+
+        // 每归还一个就恢复一个等待者，顺序与等待顺序一致
+        for (int i = 0; i < 3; ++i) {
+            held.pop_back();
+            assert(order.size() == static_cast<size_t>(i + 1));
+            assert(order[i] == i && "Waiters should be served in FIFO order");
+        }
+
+        // 池未耗尽时 co_await 直接完成
+        sink.clear();
+        acquire_and_record(pool, order, sink, 3);
+        assert(order.size() == 4 && order[3] == 3);
+
+        cout << "✅ PASSED" << endl;
+    } catch (const exception& e) {
+        cout << "❌ FAILED: " << e.what() << endl;
+    }
+}
+
+void test_case_15() {
+    cout << "Test 15: 线程本地缓存 - ";
+    try {
+        BufferPool pool(256, 16, BufferPoolOptions{.magazine_size = 8});
+        assert(pool.magazine_size() == 8);
+
+        // 单线程反复获取归还，几乎全部命中本地缓存
+        for (int i = 0; i < 1000; ++i) {
+            auto buf = pool.acquire();
+            buf.data()[0] = 1;
+        }
+        assert(pool.magazine_hit_ratio() > 0.99 && "Most operations should hit the magazine");
+
+        // 缓冲区全部囤在另一线程的缓存里，本线程仍能把池取空
+        thread hoarder([&pool]() {
+            vector<Buffer> buffers;
+            for (int i = 0; i < 16; ++i) buffers.push_back(pool.acquire());
+        });
+        hoarder.join();
+
+        vector<Buffer> buffers;
+        for (int i = 0; i < 16; ++i) buffers.push_back(pool.acquire());
+        assert(!pool.try_acquire() && "Pool should be exhausted");
+
+        // 等待者不会因为缓冲区被囤在本地缓存里而饿死
+        thread waiter([&pool]() {
+            auto buf = pool.acquire_wait();
+        });
+        this_thread::sleep_for(milliseconds(20));
+        buffers.clear();
+        waiter.join();
+
+        cout << "✅ PASSED" << endl;
+    } catch (const exception& e) {
+        cout << "❌ FAILED: " << e.what() << endl;
+    }
+}
+
+void test_case_16() {
+    cout << "Test 16: 线程本地缓存竞争性能 - " << endl;
+    try {
+        constexpr int ops_per_thread = 200000;
+        unsigned max_threads = max(32u, thread::hardware_concurrency());
+
+        for (unsigned thread_count = 1; thread_count <= max_threads; thread_count *= 2) {
+            BufferPool pool(1024, thread_count * 64, BufferPoolOptions{.magazine_size = 32});
+
+            vector<thread> threads;
+            auto start = high_resolution_clock::now();
+            for (unsigned t = 0; t < thread_count; ++t) {
+                threads.emplace_back([&pool]() {
+                    // 每次持有几个，模拟同时处理多个请求
+                    vector<Buffer> held;
+                    held.reserve(4);
+                    for (int i = 0; i < ops_per_thread / 4; ++i) {
+                        for (int k = 0; k < 4; ++k) held.push_back(pool.acquire());
+                        held.clear();
+                    }
+                });
+            }
+            for (auto& th : threads) th.join();
+            auto end = high_resolution_clock::now();
+
+            double seconds = duration<double>(end - start).count();
+            cout << "  " << thread_count << " threads: "
+                 << static_cast<long long>(thread_count * ops_per_thread / seconds) << " acquires/s, "
+                 << "local hit ratio " << pool.magazine_hit_ratio() << endl;
+        }
+        cout << "  ✅ PASSED" << endl;
+    } catch (const exception& e) {
+        cout << "❌ FAILED: " << e.what() << endl;
+    }
+}
+
+void test_case_17() {
+    cout << "Test 17: 多档位缓冲池 - ";
+    try {
+        TieredBufferPool pool(TieredBufferPool::power_of_two_tiers(512, 64 * 1024, 2));
+        assert(pool.size_class(1) == 512);
+        assert(pool.size_class(513) == 1024);
+        assert(pool.size_class(64 * 1024) == 64 * 1024);
+        assert(pool.size_class(64 * 1024 + 1) == 0);
+
+        {
+            // 取能装下请求的最小档位
+            auto small = pool.acquire(100);
+            auto medium = pool.acquire(3000);
+            memset(small.data(), 'S', 512);
+            memset(medium.data(), 'M', 4096);
+
+            auto stats = pool.stats();
+            assert(stats.size() == 8);
+            assert(stats[0].buffer_size == 512 && stats[0].in_use == 1);
+            assert(stats[3].buffer_size == 4096 && stats[3].in_use == 1);
+            assert(stats[1].in_use == 0);
+        }
+
+        // 最小档耗尽后向上借用，并记入 spills
+        vector<Buffer> buffers;
+        for (int i = 0; i < 3; ++i) buffers.push_back(pool.acquire(512));
+        auto stats = pool.stats();
+        assert(stats[0].in_use == 2 && stats[0].high_water == 2);
+        assert(stats[1].in_use == 1);
+        assert(stats[0].requests == 4 && stats[0].spills == 1);
+
+        // 超过最大档位
+        bool too_large = false;
+        try {
+            auto buf = pool.acquire(1 << 20);
+        } catch (const length_error&) {
+            too_large = true;
+        }
+        assert(too_large && "Oversized request should throw length_error");
+
+        // 全部耗尽
+        for (int i = 0; i < 13; ++i) buffers.push_back(pool.acquire(1));
+        assert(!pool.try_acquire(1) && "All tiers should be exhausted");
+        assert(pool.stats()[0].failures == 1);
+
+        buffers.clear();
+        assert(pool.stats()[0].in_use == 0);
+
+        cout << "✅ PASSED" << endl;
+    } catch (const exception& e) {
+        cout << "❌ FAILED: " << e.what() << endl;
+    }
+}
+
+void test_case_18() {
+    cout << "Test 18: 弹性扩容与收缩 - ";
+    try {
+        BufferPoolOptions options;
+        options.max_pool_size = 16;
+        options.slab_size = 4;
+        options.shrink_cooldown = milliseconds(20);
+        BufferPool pool(64, 4, options);
+        assert(pool.capacity() == 4 && pool.max_capacity() == 16);
+
+        // 按需扩容到上限，已发出的 Buffer 始终有效
+        vector<Buffer> buffers;
+        for (int i = 0; i < 16; ++i) {
+            buffers.push_back(pool.acquire());
+            memset(buffers.back().data(), 'a' + i, 64);
+        }
+        assert(pool.capacity() == 16);
+        for (int i = 0; i < 16; ++i) {
+            assert(buffers[i].data()[0] == 'a' + i && buffers[i].data()[63] == 'a' + i);
+        }
+        assert(!pool.try_acquire() && "Pool should stop growing at max_pool_size");
+
+        // 冷却期内不收缩
+        buffers.clear();
+        assert(pool.trim() == 0 && pool.capacity() == 16);
+
+        // 冷却后释放多余的 slab，但不低于初始容量
+        this_thread::sleep_for(milliseconds(30));
+        assert(pool.trim() == 3 && pool.capacity() == 4);
+
+        // 部分占用的 slab 不会被释放
+        for (int i = 0; i < 6; ++i) buffers.push_back(pool.acquire());
+        assert(pool.capacity() == 8);
+        buffers.erase(buffers.begin(), buffers.begin() + 2);
+        this_thread::sleep_for(milliseconds(30));
+        pool.trim();
+        assert(pool.capacity() == 8);
+        for (int i = 0; i < 4; ++i) buffers.push_back(pool.acquire());
+        assert(pool.capacity() == 8);
+
+        cout << "✅ PASSED" << endl;
+    } catch (const exception& e) {
+        cout << "❌ FAILED: " << e.what() << endl;
+    }
+}
+
+void test_case_19() {
+    cout << "Test 19: 多线程弹性扩缩 - ";
+    try {
+        BufferPoolOptions options;
+        options.max_pool_size = 256;
+        options.slab_size = 8;
+        options.shrink_cooldown = milliseconds(0);
+        BufferPool pool(64, 8, options);
+        atomic<bool> corrupted{false};
+
+        vector<thread> threads;
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&pool, &corrupted, t]() {
+                vector<Buffer> held;
+                for (int round = 0; round < 2000; ++round) {
+                    // 突发获取一批再全部归还，反复触发扩容和收缩
+                    int burst = 1 + (round * 7 + t) % 24;
+                    for (int i = 0; i < burst; ++i) {
+                        held.push_back(pool.acquire());
+                        memset(held.back().data(), 'a' + t, 64);
+                    }
+                    for (auto& buf : held) {
+                        if (buf.data()[0] != 'a' + t || buf.data()[63] != 'a' + t) corrupted = true;
+                    }
+                    held.clear();
+                }
+            });
+        }
+        for (auto& th : threads) th.join();
+
+        assert(!corrupted && "A buffer was handed out twice");
+        assert(pool.in_use() == 0);
+        pool.trim();
+        assert(pool.capacity() == 8 && "Idle slabs should be released");
+
+        cout << "✅ PASSED" << endl;
+    } catch (const exception& e) {
+        cout << "❌ FAILED: " << e.what() << endl;
+    }
+}
+
+void test_case_20() {
+    cout << "Test 20: mmap / 对齐存储 - ";
+    try {
+        // 按 cache line 对齐，相邻缓冲区不共享 cache line
+        BufferPoolOptions aligned;
+        aligned.storage = BufferStorage::Mmap;
+        aligned.alignment = 64;
+        BufferPool line_pool(100, 32, aligned);
+        vector<Buffer> buffers;
+        for (int i = 0; i < 32; ++i) {
+            buffers.push_back(line_pool.acquire());
+            assert(reinterpret_cast<uintptr_t>(buffers.back().data()) % 64 == 0);
+            memset(buffers.back().data(), 'a' + i % 26, 100);
+        }
+        for (int i = 0; i < 32; ++i) assert(buffers[i].data()[99] == 'a' + i % 26);
+        buffers.clear();
+
+        // 按页对齐 + 大页（没有预留大页时退回普通页）+ 预先缺页 + 弹性扩容
+        BufferPoolOptions paged;
+        paged.storage = BufferStorage::Mmap;
+        paged.alignment = SlabAllocator::page_size();
+        paged.huge_pages = true;
+        paged.prefault = true;
+        paged.max_pool_size = 64;
+        paged.slab_size = 16;
+        BufferPool page_pool(1000, 16, paged);
+        vector<Buffer> pages;
+        for (int i = 0; i < 64; ++i) {
+            pages.push_back(page_pool.acquire());
+            assert(reinterpret_cast<uintptr_t>(pages.back().data()) % SlabAllocator::page_size() == 0);
+            memset(pages.back().data(), 'x', 1000);
+        }
+        assert(page_pool.capacity() == 64);
+
+        // 对齐必须是 2 的幂
+        bool rejected = false;
+        try {
+            BufferPoolOptions bad;
+            bad.alignment = 48;
+            BufferPool bad_pool(64, 4, bad);
+        } catch (const invalid_argument&) {
+            rejected = true;
+        }
+        assert(rejected && "Non power-of-two alignment should be rejected");
+
+        // mmap 只保证按页对齐
+        rejected = false;
+        try {
+            BufferPoolOptions bad;
+            bad.storage = BufferStorage::Mmap;
+            bad.alignment = SlabAllocator::page_size() * 2;
+            BufferPool bad_pool(64, 4, bad);
+        } catch (const invalid_argument&) {
+            rejected = true;
+        }
+        assert(rejected && "Mmap alignment above the page size should be rejected");
+
+        cout << "✅ PASSED (huge page slabs: " << page_pool.huge_page_slabs() << ")" << endl;
+    } catch (const exception& e) {
+        cout << "❌ FAILED: " << e.what() << endl;
+    }
+}
+
+void test_case_21() {
+    cout << "Test 21: 预先缺页对首次写入的影响 - " << endl;
+    try {
+        constexpr size_t buffer_size = 64 * 1024;
+        constexpr size_t pool_size = 1024;
+
+        for (bool prefault : {false, true}) {
+            BufferPoolOptions options;
+            options.storage = BufferStorage::Mmap;
+            options.alignment = SlabAllocator::page_size();
+            options.prefault = prefault;
+            BufferPool pool(buffer_size, pool_size, options);
+
+            // 第一次写满所有缓冲区，未预先缺页时每页都会触发一次缺页
+            vector<Buffer> buffers;
+            auto start = high_resolution_clock::now();
+            for (size_t i = 0; i < pool_size; ++i) {
+                buffers.push_back(pool.acquire());
+                memset(buffers.back().data(), 1, buffer_size);
+            }
+            auto end = high_resolution_clock::now();
+            cout << "  prefault=" << prefault << ": "
+                 << duration_cast<microseconds>(end - start).count() << " μs" << endl;
+        }
+        cout << "  ✅ PASSED" << endl;
+    } catch (const exception& e) {
+        cout << "❌ FAILED: " << e.what() << endl;
+    }
+}
+
+void test_case_22() {
+    cout << "Test 22: 大池位图查找性能 - " << endl;
+    try {
+        constexpr size_t pool_size = 128 * 1024;
+        constexpr int ops = 1000000;
+        BufferPool pool(64, pool_size);
+
+        // 先占满，再随机归还一部分，让空闲位分散在整个位图里
+        vector<Buffer> held;
+        held.reserve(pool_size);
+        for (size_t i = 0; i < pool_size; ++i) held.push_back(pool.acquire());
+        mt19937 rng(42);
+        shuffle(held.begin(), held.end(), rng);
+
+        size_t released = 0;
+        for (double occupancy : {0.999, 0.99, 0.9, 0.5, 0.0}) {
+            size_t target_free = static_cast<size_t>(pool_size * (1.0 - occupancy));
+            for (; released < target_free; ++released) held.pop_back();
+
+            auto start = high_resolution_clock::now();
+            for (int i = 0; i < ops; ++i) {
+                auto buf = pool.acquire();
+                buf.data()[0] = 0;
+            }
+            auto end = high_resolution_clock::now();
+            double seconds = duration<double>(end - start).count();
+            cout << "  occupancy " << occupancy * 100 << "%: "
+                 << static_cast<long long>(ops / seconds) << " acquires/s" << endl;
+        }
+        assert(pool.in_use() == 0);
+        cout << "  ✅ PASSED" << endl;
+    } catch (const exception& e) {
+        cout << "❌ FAILED: " << e.what() << endl;
+    }
+}
+
+void test_case_23() {
+    cout << "Test 23: BufferChain 分散/聚集读写 - ";
+    try {
+        BufferPool pool(256, 64);
+        BufferChain chain(pool);
+
+        // 追加跨越多段，iovec 覆盖全部可读字节
+        string payload;
+        for (int i = 0; i < 1000; ++i) payload += static_cast<char>('a' + i % 26);
+        chain.append(payload.data(), payload.size());
+        assert(chain.size() == 1000 && chain.segment_count() == 4);
+        auto slices = chain.readable();
+        assert(slices.size() == 4);
+        size_t total = 0;
+        for (auto& slice : slices) total += slice.iov_len;
+        assert(total == 1000 && slices[3].iov_len == 1000 - 3 * 256);
+
+        // 消费掉整段后立即归还池
+        chain.consume(300);
+        assert(chain.segment_count() == 3 && pool.in_use() == 3);
+        assert(static_cast<char*>(chain.readable()[0].iov_base)[0] == payload[300]);
+
+        string out(700, '\0');
+        assert(chain.read(out.data(), out.size()) == 700);
+        assert(out == payload.substr(300) && chain.empty());
+        assert(pool.in_use() == 1);
+
+#ifndef _WIN32
+        // 经 pipe 往返：writev 直接从池内存发出，readv 直接写进池内存
+        int fds[2];
+        assert(pipe(fds) == 0);
+        BufferPool page_pool(4096, 32);
+        BufferChain sender(page_pool), receiver(page_pool);
+        string big(40000, '\0');
+        for (size_t i = 0; i < big.size(); ++i) big[i] = static_cast<char>(i * 31);
+        sender.append(big.data(), big.size());
+        while (!sender.empty()) assert(sender.write_to(fds[1]) > 0);
+        close(fds[1]);
+        while (receiver.read_from(fds[0], 4096) > 0) {}
+        close(fds[0]);
+
+        string received(receiver.size(), '\0');
+        receiver.read(received.data(), received.size());
+        assert(received == big);
+#endif
+
+        cout << "✅ PASSED" << endl;
+    } catch (const exception& e) {
+        cout << "❌ FAILED: " << e.what() << endl;
+    }
+}
+
+void test_case_24() {
+    cout << "Test 24: SharedBuffer 零拷贝分发 - ";
+    try {
+        BufferPool pool(1024, 4);
+        SharedBuffer shared{pool.acquire()};
+        strcpy(shared.data(), "header|payload|trailer");
+        assert(shared.use_count() == 1 && pool.in_use() == 1);
+
+        BufferSlice header = shared.slice(0, 6);
+        BufferSlice payload = shared.slice(7, 7);
+        BufferSlice trailer = payload.slice(0, 0);
+        assert(string(header.data(), header.size()) == "header");
+        assert(string(payload.data(), payload.size()) == "payload");
+        assert(payload.data() == shared.data() + 7 && trailer.empty());
+        assert(shared.use_count() == 4);
+
+        // 越界切片
+        bool thrown = false;
+        try { (void)payload.slice(3, 5); } catch (const out_of_range&) { thrown = true; }
+        assert(thrown);
+
+        // 生产者先放手，视图仍然有效
+        shared.reset();
+        trailer.reset();
+        assert(pool.in_use() == 1 && header.use_count() == 2);
+        BufferSlice copy = header;
+        copy = payload;
+        copy = copy;
+        assert(copy.data() == payload.data() && payload.use_count() == 3);
+        assert(header.use_count() == 3);
+        header.reset();
+        payload.reset();
+        assert(pool.in_use() == 1);
+        copy.reset();
+        assert(pool.in_use() == 0);
+
+        // 多个消费者线程各持一份视图，最后一个释放时归还
+        for (int round = 0; round < 100; ++round) {
+            SharedBuffer msg{pool.acquire()};
+            memset(msg.data(), 'x', 1024);
+            vector<thread> consumers;
+            atomic<size_t> seen{0};
+            for (int i = 0; i < 4; ++i) {
+                consumers.emplace_back([view = msg.slice(i * 256, 256), &seen]() mutable {
+                    size_t n = 0;
+                    for (size_t k = 0; k < view.size(); ++k) n += view.data()[k] == 'x';
+                    seen.fetch_add(n);
+                    view.reset();
+                });
+            }
+            msg.reset();
+            for (auto& t : consumers) t.join();
+            assert(seen.load() == 1024);
+        }
+        assert(pool.in_use() == 0);
+
+        // 非 BufferPool 的 Buffer 不能共享
+        thrown = false;
+        try {
+            SharedBuffer bad{Buffer{0, nullptr, [](size_t, void*) {}, nullptr}};
+        } catch (const invalid_argument&) { thrown = true; }
+        assert(thrown);
+
+        cout << "✅ PASSED" << endl;
+    } catch (const exception& e) {
+        cout << "❌ FAILED: " << e.what() << endl;
+    }
+}
+
+void test_case_25() {
+    cout << "Test 25: 编译期定长缓冲池 vs BufferPool - " << endl;
+    try {
+        using Small = FixedBufferPool<128, 100>;
+        {
+            // 基本语义与 BufferPool 一致
+            vector<Small::Handle> handles;
+            for (int i = 0; i < 100; ++i) {
+                handles.push_back(Small::acquire());
+                memset(handles.back().data(), i, Small::buffer_size);
+            }
+            assert(Small::in_use() == 100 && !Small::try_acquire());
+            for (int i = 0; i < 100; ++i) assert(handles[i].data()[127] == static_cast<char>(i));
+
+            bool thrown = false;
+            try { auto h = Small::acquire(); } catch (const runtime_error&) { thrown = true; }
+            assert(thrown);
+
+            Small::Handle moved = std::move(handles[0]);
+            assert(!handles[0] && moved);
+            handles.clear();
+            assert(Small::in_use() == 1);
+        }
+        assert(Small::in_use() == 0);
+
+        // 多线程争用
+        {
+            using Shared = FixedBufferPool<64, 256, struct SharedTag>;
+            vector<thread> threads;
+            for (int t = 0; t < 8; ++t) {
+                threads.emplace_back([t]() {
+                    for (int i = 0; i < 20000; ++i) {
+                        auto h = Shared::acquire();
+                        h.data()[0] = static_cast<char>(t);
+                        assert(h.data()[0] == static_cast<char>(t));
+                    }
+                });
+            }
+            for (auto& th : threads) th.join();
+            assert(Shared::in_use() == 0);
+        }
+
+        cout << "  handle size: Buffer " << sizeof(Buffer) << " bytes, FixedBufferPool::Handle "
+             << sizeof(FixedBufferPool<4096, 1024>::Handle) << " bytes" << endl;
+
+        constexpr int rounds = 2000;
+        constexpr int batch = 64;
+        auto bench = [&](auto&& acquire) {
+            auto start = high_resolution_clock::now();
+            for (int r = 0; r < rounds; ++r) acquire();
+            return duration<double>(high_resolution_clock::now() - start).count();
+        };
+
+        BufferPool pool(4096, 1024);
+        double runtime_seconds = bench([&] {
+            vector<Buffer> held;
+            held.reserve(batch);
+            for (int i = 0; i < batch; ++i) held.push_back(pool.acquire());
+        });
+
+        using Fixed = FixedBufferPool<4096, 1024>;
+        double fixed_seconds = bench([&] {
+            vector<Fixed::Handle> held;
+            held.reserve(batch);
+            for (int i = 0; i < batch; ++i) held.push_back(Fixed::acquire());
+        });
+
+        double ops = static_cast<double>(rounds) * batch;
+        cout << "  BufferPool:      " << static_cast<long long>(ops / runtime_seconds) << " acquire+release/s" << endl;
+        cout << "  FixedBufferPool: " << static_cast<long long>(ops / fixed_seconds) << " acquire+release/s" << endl;
+        cout << "  ✅ PASSED" << endl;
+    } catch (const exception& e) {
+        cout << "❌ FAILED: " << e.what() << endl;
+    }
+}
+
+// 生产者取 Buffer、写入时间戳后交给消费者，消费者记录交接延迟
+template<class Push, class Pop>
+void run_handoff_benchmark(const char* name, BufferPool& pool, unsigned producers, unsigned consumers,
+                           size_t per_producer, Push&& push, Pop&& pop) {
+    size_t total = per_producer * producers;
+    atomic<size_t> consumed{0};
+    vector<vector<int64_t>> latencies(consumers);
+
+    auto now_ns = [] { return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count(); };
+    vector<thread> threads;
+    auto start = steady_clock::now();
+    for (unsigned p = 0; p < producers; ++p) {
+        threads.emplace_back([&]() {
+            for (size_t i = 0; i < per_producer; ++i) {
+                optional<Buffer> buf;
+                while (!(buf = pool.try_acquire())) this_thread::yield();
+                int64_t stamp = now_ns();
+                memcpy(buf->data(), &stamp, sizeof(stamp));
+                while (!push(*buf)) this_thread::yield();
+            }
+        });
+    }
+    for (unsigned c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c]() {
+            auto& samples = latencies[c];
+            samples.reserve(total / consumers + 1);
+            while (consumed.load(memory_order_relaxed) < total) {
+                optional<Buffer> buf = pop();
+                if (!buf) { this_thread::yield(); continue; }
+                int64_t stamp;
+                memcpy(&stamp, buf->data(), sizeof(stamp));
+                samples.push_back(now_ns() - stamp);
+                consumed.fetch_add(1, memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    double seconds = duration<double>(steady_clock::now() - start).count();
+
+    vector<int64_t> all;
+    for (auto& samples : latencies) all.insert(all.end(), samples.begin(), samples.end());
+    assert(all.size() == total && pool.in_use() == 0);
+    auto p99 = all.begin() + static_cast<ptrdiff_t>(all.size() * 99 / 100);
+    nth_element(all.begin(), p99, all.end());
+    cout << "  " << name << " " << producers << "P/" << consumers << "C: "
+         << static_cast<long long>(total / seconds) << " handoffs/s, p99 " << *p99 << " ns" << endl;
+}
+
+void test_case_26() {
+    cout << "Test 26: Buffer 无锁环形队列 - " << endl;
+    try {
+        BufferPool pool(64, 1024);
+        {
+            // 语义：容量取 2 的幂，满时 push 失败且不移走参数
+            SpscBufferQueue spsc(5);
+            assert(spsc.capacity() == 8);
+            for (int i = 0; i < 8; ++i) {
+                Buffer buf = pool.acquire();
+                buf.data()[0] = static_cast<char>(i);
+                assert(spsc.try_push(std::move(buf)));
+            }
+            Buffer extra = pool.acquire();
+            assert(!spsc.try_push(std::move(extra)) && extra.data() != nullptr);
+            for (int i = 0; i < 8; ++i) assert(spsc.try_pop()->data()[0] == static_cast<char>(i));
+            assert(!spsc.try_pop());
+
+            // 批量接口
+            vector<Buffer> batch;
+            for (int i = 0; i < 6; ++i) batch.push_back(pool.acquire());
+            assert(spsc.try_push_batch(batch.begin(), batch.size()) == 6);
+            vector<Buffer> out;
+            assert(spsc.try_pop_batch(back_inserter(out), 4) == 4);
+            assert(out.size() == 4 && spsc.size() == 2);
+
+            MpmcBufferQueue mpmc(4);
+            assert(mpmc.try_push_batch(out.begin(), out.size()) == 4);
+            assert(!mpmc.try_push(std::move(extra)));
+            out.clear();
+            assert(mpmc.try_pop_batch(back_inserter(out), 10) == 4);
+            assert(!mpmc.try_pop());
+        }
+        // 队列析构时释放残留的 Buffer
+        assert(pool.in_use() == 0);
+
+        // MPMC 批量交接不丢不重
+        {
+            MpmcBufferQueue queue(64);
+            constexpr int per_producer = 20000;
+            atomic<long long> sum{0};
+            atomic<int> received{0};
+            vector<thread> threads;
+            for (int p = 0; p < 4; ++p) {
+                threads.emplace_back([&, p]() {
+                    vector<Buffer> batch;
+                    for (int i = 0; i < per_producer;) {
+                        optional<Buffer> buf = pool.try_acquire();
+                        if (buf) {
+                            int value = p * per_producer + i++;
+                            memcpy(buf->data(), &value, sizeof(value));
+                            batch.push_back(std::move(*buf));
+                        }
+                        if (batch.size() == 8 || (!buf && !batch.empty()) || i == per_producer) {
+                            size_t pushed = 0;
+                            while (pushed < batch.size()) {
+                                pushed += queue.try_push_batch(batch.begin() + static_cast<ptrdiff_t>(pushed),
+                                                               batch.size() - pushed);
+                            }
+                            batch.clear();
+                        }
+                    }
+                });
+            }
+            for (int c = 0; c < 4; ++c) {
+                threads.emplace_back([&]() {
+                    vector<Buffer> out;
+                    while (received.load() < 4 * per_producer) {
+                        out.clear();
+                        queue.try_pop_batch(back_inserter(out), 8);
+                        for (auto& buf : out) {
+                            int value;
+                            memcpy(&value, buf.data(), sizeof(value));
+                            sum.fetch_add(value);
+                        }
+                        received.fetch_add(static_cast<int>(out.size()));
+                    }
+                });
+            }
+            for (auto& th : threads) th.join();
+            long long n = 4LL * per_producer;
+            assert(sum.load() == n * (n - 1) / 2);
+            assert(pool.in_use() == 0);
+        }
+
+        // 吞吐与 p99 延迟，对比 mutex + std::queue
+        constexpr size_t per_producer = 200000;
+        {
+            SpscBufferQueue queue(256);
+            run_handoff_benchmark("SPSC ring     ", pool, 1, 1, per_producer,
+                [&](Buffer& buf) { return queue.try_push(std::move(buf)); },
+                [&] { return queue.try_pop(); });
+        }
+        for (unsigned n : {1u, 4u}) {
+            MpmcBufferQueue queue(256);
+            run_handoff_benchmark("MPMC ring     ", pool, n, n, per_producer / n,
+                [&](Buffer& buf) { return queue.try_push(std::move(buf)); },
+                [&] { return queue.try_pop(); });
+
+            mutex m;
+            std::queue<Buffer> locked;
+            run_handoff_benchmark("mutex + queue ", pool, n, n, per_producer / n,
+                [&](Buffer& buf) { lock_guard lock(m); locked.push(std::move(buf)); return true; },
+                [&]() -> optional<Buffer> {
+                    lock_guard lock(m);
+                    if (locked.empty()) return nullopt;
+                    optional<Buffer> buf{std::move(locked.front())};
+                    locked.pop();
+                    return buf;
+                });
+        }
+        cout << "  ✅ PASSED" << endl;
+    } catch (const exception& e) {
+        cout << "❌ FAILED: " << e.what() << endl;
+    }
+}
+
+// 模拟解析：按 8 字节滚动哈希，尾部逐字节
+uint64_t parse_bytes(const char* data, size_t n, uint64_t h) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        h = (h ^ word) * 1099511628211ULL;
+    }
+    for (; i < n; ++i) h = (h ^ static_cast<unsigned char>(data[i])) * 1099511628211ULL;
+    return h;
+}
+
+void test_case_27() {
+    cout << "Test 27: 预读文件读取器 vs ifstream - " << endl;
+    try {
+        auto path = filesystem::temp_directory_path() / "day1_prefetch_test.bin";
+        // 故意不是块大小的整数倍
+        constexpr size_t file_bytes = 64 * 1024 * 1024 + 12345;
+        {
+            ofstream out(path, ios::binary);
+            mt19937_64 rng(42);
+            vector<uint64_t> block(8192);
+            for (size_t written = 0; written < file_bytes; written += block.size() * 8) {
+                for (auto& v : block) v = rng();
+                out.write(reinterpret_cast<const char*>(block.data()),
+                          static_cast<streamsize>(min(block.size() * 8, file_bytes - written)));
+            }
+        }
+
+        constexpr size_t chunk = 256 * 1024;
+        uint64_t expected = 1469598103934665603ULL;
+        auto start = steady_clock::now();
+        {
+            ifstream in(path, ios::binary);
+            vector<char> buf(chunk);
+            while (in) {
+                in.read(buf.data(), static_cast<streamsize>(chunk));
+                expected = parse_bytes(buf.data(), static_cast<size_t>(in.gcount()), expected);
+            }
+        }
+        double ifstream_seconds = duration<double>(steady_clock::now() - start).count();
+
+        BufferPool pool(chunk, 16);
+        for (size_t threads : {1, 2}) {
+            uint64_t h = 1469598103934665603ULL;
+            size_t next_offset = 0;
+            start = steady_clock::now();
+            PrefetchReader reader(pool, path.string(), 4, threads);
+            assert(reader.size() == file_bytes && reader.chunk_count() == file_bytes / chunk + 1);
+            size_t bytes = reader.for_each([&](const PrefetchReader::Chunk& c) {
+                // 按文件顺序交付
+                assert(c.offset == next_offset);
+                next_offset += c.size;
+                h = parse_bytes(c.data(), c.size, h);
+            });
+            double seconds = duration<double>(steady_clock::now() - start).count();
+            assert(bytes == file_bytes && h == expected);
+            assert(!reader.next());
+            cout << "  PrefetchReader x" << threads << ": "
+                 << static_cast<long long>(file_bytes / seconds / 1e6) << " MB/s" << endl;
+        }
+        cout << "  ifstream loop:     " << static_cast<long long>(file_bytes / ifstream_seconds / 1e6) << " MB/s" << endl;
+        assert(pool.in_use() == 0);
+
+        {
+            // 提前析构：在途的块归还池
+            PrefetchReader reader(pool, path.string(), 8);
+            auto first = reader.next();
+            assert(first && first->size == chunk);
+        }
+        assert(pool.in_use() == 0);
+
+        bool thrown = false;
+        try { PrefetchReader missing(pool, (path.string() + ".missing")); } catch (const system_error&) { thrown = true; }
+        assert(thrown);
+
+        filesystem::remove(path);
+        cout << "  ✅ PASSED" << endl;
+    } catch (const exception& e) {
+        cout << "❌ FAILED: " << e.what() << endl;
+    }
+}
+
+void test_case_28() {
+    cout << "Test 28: 池统计快照 - ";
+    try {
+        BufferPool pool(64, 4);
+        {
+            vector<Buffer> held;
+            for (int i = 0; i < 4; ++i) held.push_back(pool.acquire());
+            assert(!pool.try_acquire());
+            bool thrown = false;
+            try { auto b = pool.acquire(); } catch (const runtime_error&) { thrown = true; }
+            assert(thrown);
+            assert(!pool.try_acquire_for(milliseconds(1)));
+            held.pop_back();
+            held.pop_back();
+
+            auto s = pool.stats();
+            assert(s.capacity == 4 && s.max_capacity == 4);
+            assert(s.acquires == 4 && s.releases == 2 && s.failures == 3);
+            assert(s.in_use == 2 && s.high_water == 4);
+            assert(s.waits == 0 && s.wait_histogram[0] == 4);
+        }
+
+        // 等待耗时进入直方图
+        {
+            vector<Buffer> held;
+            for (int i = 0; i < 4; ++i) held.push_back(pool.acquire());
+            thread releaser([&held]() {
+                this_thread::sleep_for(milliseconds(5));
+                held.pop_back();
+            });
+            Buffer waited = pool.acquire_wait();
+            releaser.join();
+
+            auto s = pool.stats();
+            assert(s.waits == 1);
+            size_t bucket = 0;
+            for (size_t k = 1; k < BufferPoolStats::wait_buckets; ++k) {
+                if (s.wait_histogram[k]) bucket = k;
+            }
+            // 至少等了 5ms，落在 [4096us, ...) 的档位
+            assert(BufferPoolStats::bucket_limit_us(bucket) == 0 || BufferPoolStats::bucket_limit_us(bucket) > 4096);
+            assert(s.wait_percentile_us(1.0) >= 8192 || s.wait_percentile_us(1.0) == 0);
+            assert(s.wait_percentile_us(0.5) == 1);
+        }
+        assert(pool.in_use() == 0);
+
+        // 没有耗尽池的峰值也要记下
+        {
+            BufferPool roomy(64, 100);
+            {
+                vector<Buffer> held;
+                for (int i = 0; i < 10; ++i) held.push_back(roomy.acquire());
+            }
+            assert(roomy.in_use() == 0);
+            assert(roomy.high_water() == 10 && roomy.stats().high_water == 10);
+        }
+
+        // 多档位池的各档峰值来自各自的 high_water()
+        {
+            TieredBufferPool tiered(TieredBufferPool::power_of_two_tiers(512, 4096, 64));
+            {
+                vector<Buffer> held;
+                for (int i = 0; i < 30; ++i) held.push_back(tiered.acquire(600));
+            }
+            auto tiers = tiered.stats();
+            assert(tiers[1].buffer_size == 1024 && tiers[1].in_use == 0 && tiers[1].high_water == 30);
+            assert(tiers[0].high_water == 0);
+        }
+
+        // 各线程的计数在读取时汇总
+        {
+            BufferPool shared(64, 64, BufferPoolOptions{.magazine_size = 8});
+            vector<thread> threads;
+            for (int t = 0; t < 8; ++t) {
+                threads.emplace_back([&shared]() {
+                    for (int i = 0; i < 10000; ++i) {
+                        auto a = shared.acquire();
+                        auto b = shared.acquire();
+                    }
+                });
+            }
+            for (auto& th : threads) th.join();
+            auto s = shared.stats();
+            assert(s.acquires == 160000 && s.releases == 160000 && s.in_use == 0);
+            // 线程缓存中的空闲缓冲区也计入峰值
+            assert(s.high_water >= 2 && s.high_water <= 64);
+            assert(s.failures == 0 && s.magazine_hit_ratio > 0.0);
+        }
+
+        cout << "✅ PASSED" << endl;
+    } catch (const exception& e) {
+        cout << "❌ FAILED: " << e.what() << endl;
+    }
+}
+
+void test_case_29() {
+    cout << "Test 29: 大页 + 预先缺页 - ";
+    try {
+        size_t huge = SlabAllocator::huge_page_size();
+        size_t page = SlabAllocator::page_size();
+        SlabAllocator allocator(BufferStorage::Mmap, page, true, true);
+        size_t bytes = 3 * huge + 100;
+        char *p = allocator.allocate(bytes);
+        // 不论 MAP_HUGETLB 还是透明大页，slab 都按大页对齐
+        assert(reinterpret_cast<uintptr_t>(p) % huge == 0);
+
+        size_t anon_huge_kb = 0;
+#ifndef _WIN32
+        // 预先缺页在 madvise 之后进行，分配返回时所有页都已驻留
+        size_t length = 4 * huge;
+        vector<unsigned char> resident(length / page);
+        assert(mincore(p, length, resident.data()) == 0);
+        for (auto r : resident) assert(r & 1);
+#endif
+#ifdef __linux__
+        // 透明大页是否生效取决于系统配置，只报告不断言
+        ifstream smaps("/proc/self/smaps");
+        string line;
+        bool in_slab = false;
+        while (getline(smaps, line)) {
+            unsigned long lo, hi;
+            if (sscanf(line.c_str(), "%lx-%lx ", &lo, &hi) == 2) {
+                in_slab = lo <= reinterpret_cast<uintptr_t>(p) && reinterpret_cast<uintptr_t>(p) < hi;
+            } else if (in_slab && line.rfind("AnonHugePages:", 0) == 0) {
+                anon_huge_kb = stoul(line.substr(14));
+            }
+        }
+#endif
+        memset(p, 'h', bytes);
+        allocator.deallocate(p, bytes);
+
+        cout << "✅ PASSED (hugetlb slabs: " << allocator.huge_page_slabs()
+             << ", AnonHugePages: " << anon_huge_kb << " kB)" << endl;
+    } catch (const exception& e) {
+        cout << "❌ FAILED: " << e.what() << endl;
+    }
+}
+
 int main() {
     cout << "\n╔═══════════════════════════════════════════════╗" << endl;
     cout << "║  BufferPool 测试套件 (原始题目)              ║" << endl;
@@ -279,6 +1377,25 @@ int main() {
     test_case_8();
     test_case_9();
     test_case_10();
+    test_case_11();
+    test_case_12();
+    test_case_13();
+    test_case_14();
+    test_case_15();
+    test_case_16();
+    test_case_17();
+    test_case_18();
+    test_case_19();
+    test_case_20();
+    test_case_21();
+    test_case_22();
+    test_case_23();
+    test_case_24();
+    test_case_25();
+    test_case_26();
+    test_case_27();
+    test_case_28();
+    test_case_29();
 
     cout << "\n═══════════════════════════════════════════════" << endl;
     cout << "测试完成！" << endl;
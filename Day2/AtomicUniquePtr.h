@@ -0,0 +1,248 @@
+#ifndef DAY2_ATOMICUNIQUEPTR_H
+#define DAY2_ATOMICUNIQUEPTR_H
+// 模板类必须全部写在头文件中。
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "UniquePtr.h"
+
+// 基于 epoch 的延迟回收（EBR）
+// 读者进入临界区时把当前全局 epoch 记在自己的记录里；写者换下的旧对象标上当时的 epoch E 挂起，
+// 全局 epoch 每推进一次都要求所有在读的读者已看到当前值，推进到 E + 2 时不可能还有读者持有旧对象，才真正销毁
+class EpochDomain {
+    // 每个线程一条记录，线程退出后留给新线程复用，不释放
+    struct alignas(64) Record {
+        // 低位为 1 表示在读，高位为进入时的 epoch
+        std::atomic<uint64_t> local{0};
+        std::atomic<bool> in_use{true};
+        // 只有所属线程访问
+        unsigned nesting = 0;
+        Record* next = nullptr;
+    };
+
+    struct Retired {
+        void* p;
+        void (*destroy)(void*) noexcept;
+        uint64_t epoch;
+    };
+
+    // 线程退出时交还记录
+    struct LocalRecord {
+        Record* record = nullptr;
+
+        ~LocalRecord() {
+            if (record) record->in_use.store(false, std::memory_order_release);
+        }
+    };
+
+    alignas(64) std::atomic<uint64_t> epoch{1};
+    std::atomic<Record*> records{nullptr};
+
+    // 挂起的旧对象只有写者访问，写者少，用锁即可
+    std::mutex mtx;
+    std::vector<Retired> retired;
+
+    EpochDomain() = default;
+
+    ~EpochDomain() {
+        // 进程退出时所有读者都已结束
+        for (auto& r : retired) r.destroy(r.p);
+        for (Record* r = records.load(std::memory_order_acquire); r;) {
+            Record* next = r->next;
+            delete r;
+            r = next;
+        }
+    }
+
+    Record* acquireRecord() {
+        // 先找已退出线程留下的记录
+        for (Record* r = records.load(std::memory_order_acquire); r; r = r->next) {
+            bool free = false;
+            if (!r->in_use.load(std::memory_order_relaxed) &&
+                r->in_use.compare_exchange_strong(free, true, std::memory_order_acquire)) {
+                return r;
+            }
+        }
+        auto* r = new Record;
+        Record* head = records.load(std::memory_order_relaxed);
+        do {
+            r->next = head;
+        } while (!records.compare_exchange_weak(head, r, std::memory_order_release, std::memory_order_relaxed));
+        return r;
+    }
+
+    Record* localRecord() {
+        thread_local LocalRecord local;
+        if (!local.record) local.record = acquireRecord();
+        return local.record;
+    }
+
+    // 所有在读的读者都已进入当前 epoch 时推进一步
+    bool tryAdvance() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        uint64_t current = epoch.load(std::memory_order_relaxed);
+        for (Record* r = records.load(std::memory_order_acquire); r; r = r->next) {
+            uint64_t local = r->local.load(std::memory_order_acquire);
+            if ((local & 1) && (local >> 1) != current) return false;
+        }
+        return epoch.compare_exchange_strong(current, current + 1, std::memory_order_seq_cst);
+    }
+
+public:
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    static EpochDomain& instance() {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    // 读临界区，可嵌套；持有期间读到的对象不会被销毁
+    // 只能在创建它的线程上析构
+    class Guard {
+        Record* record;
+
+    public:
+        explicit Guard(EpochDomain& domain)
+            : record(domain.localRecord()) {
+            if (record->nesting++ == 0) {
+                uint64_t e = domain.epoch.load(std::memory_order_relaxed);
+                record->local.store((e << 1) | 1, std::memory_order_relaxed);
+                // 先公开自己在读，再去读指针；与写者 retire 后的 fence 配对
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+
+        ~Guard() {
+            if (--record->nesting == 0) record->local.store(0, std::memory_order_release);
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    Guard pin() {
+        return Guard(*this);
+    }
+
+    // 挂起 p，等所有可能看到它的读者离开后调用 destroy(p)
+    void retire(void* p, void (*destroy)(void*) noexcept) {
+        if (!p) return;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        uint64_t e = epoch.load(std::memory_order_relaxed);
+        std::lock_guard lock(mtx);
+        retired.push_back({p, destroy, e});
+    }
+
+    // 尝试推进 epoch 并销毁可以回收的对象，返回销毁的个数
+    size_t collect() {
+        std::vector<Retired> ready;
+        {
+            std::lock_guard lock(mtx);
+            if (retired.empty()) return 0;
+            tryAdvance();
+            uint64_t current = epoch.load(std::memory_order_relaxed);
+            auto keep = retired.begin();
+            for (auto& r : retired) {
+                if (r.epoch + 2 <= current) ready.push_back(r);
+                else *keep++ = r;
+            }
+            retired.erase(keep, retired.end());
+        }
+        // 在锁外销毁，析构函数里再发布 / 回收也不会死锁
+        for (auto& r : ready) r.destroy(r.p);
+        return ready.size();
+    }
+
+    // 阻塞直到此前挂起的对象全部销毁；不能在读临界区内调用
+    void synchronize() {
+        while (pending()) {
+            if (!collect()) std::this_thread::yield();
+        }
+    }
+
+    size_t pending() {
+        std::lock_guard lock(mtx);
+        return retired.size();
+    }
+};
+
+// 可被多个读者无锁读取、由写者整体替换的独占指针，适合读多写少的配置表、路由表
+// 读：auto guard = p.read(); guard->...    写：p.store(makeUnique<T>(...))
+// 删除器需无状态（挂起时只记录类型擦除后的销毁函数）
+template<typename T, typename Deleter = DefaultDelete<T>>
+class AtomicUniquePtr {
+    static_assert(std::is_empty_v<Deleter> && std::is_default_constructible_v<Deleter>,
+                  "AtomicUniquePtr requires a stateless deleter");
+
+    std::atomic<T*> ptr;
+
+    static void destroy(void* p) noexcept {
+        Deleter()(static_cast<T*>(p));
+    }
+
+public:
+    // 读者持有的视图：pin 住 epoch，期间指向的对象保持有效
+    class ReadGuard {
+        EpochDomain::Guard guard;
+        const T* p;
+
+    public:
+        explicit ReadGuard(const std::atomic<T*>& source)
+            : guard(EpochDomain::instance()), p(source.load(std::memory_order_acquire)) {}
+
+        const T* get() const noexcept {
+            return p;
+        }
+
+        const T& operator*() const {
+            return *p;
+        }
+
+        const T* operator->() const noexcept {
+            return p;
+        }
+
+        explicit operator bool() const noexcept {
+            return p != nullptr;
+        }
+    };
+
+    AtomicUniquePtr() noexcept
+        : ptr(nullptr) {}
+
+    explicit AtomicUniquePtr(UniquePtr<T, Deleter> initial) noexcept
+        : ptr(initial.release()) {}
+
+    AtomicUniquePtr(const AtomicUniquePtr&) = delete;
+    AtomicUniquePtr& operator=(const AtomicUniquePtr&) = delete;
+
+    // 析构时不能再有读者
+    ~AtomicUniquePtr() noexcept {
+        T* p = ptr.load(std::memory_order_relaxed);
+        if (p) Deleter()(p);
+    }
+
+    ReadGuard read() const {
+        return ReadGuard(ptr);
+    }
+
+    // 发布新对象，旧对象交给 EpochDomain 延迟销毁；语义同 UniquePtr::reset
+    void store(UniquePtr<T, Deleter> desired) {
+        T* old = ptr.exchange(desired.release(), std::memory_order_acq_rel);
+        EpochDomain& domain = EpochDomain::instance();
+        domain.retire(old, &destroy);
+        domain.collect();
+    }
+
+    void reset() {
+        store(UniquePtr<T, Deleter>());
+    }
+};
+
+#endif // DAY2_ATOMICUNIQUEPTR_H
@@ -0,0 +1,137 @@
+#ifndef DAY2_INLINEPTR_H
+#define DAY2_INLINEPTR_H
+// 模板类必须全部写在头文件中。
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "UniquePtr.h"
+
+// 持有一个多态对象的独占指针，带小对象优化：
+// 派生类能放进 Capacity 字节（且对齐满足、移动不抛异常）时直接构造在自身内部，否则退回堆上
+// 调用仍走 Base 的虚函数；放在 vector 里时小对象连续存放，遍历时不再到处跳
+// 例：vector<InlinePtr<LogSink, 32>> sinks; sinks.push_back(InlinePtr<LogSink, 32>::make<ConsoleLogSink>());
+template<typename Base, size_t Capacity = 3 * sizeof(void*), size_t Align = alignof(std::max_align_t)>
+class InlinePtr {
+    static_assert(std::has_virtual_destructor_v<Base>, "Base must have a virtual destructor");
+
+    // 把内部存放的对象移到 dst 并析构原对象，返回新位置；为空表示对象在堆上
+    using Relocate = Base* (*)(void* dst, Base* src) noexcept;
+
+    alignas(Align) unsigned char storage[Capacity];
+    Base* ptr;
+    Relocate relocate;
+
+    template<typename D>
+    static Base* relocateAs(void* dst, Base* src) noexcept {
+        auto* from = static_cast<D*>(src);
+        D* to = ::new(dst) D(std::move(*from));
+        from->~D();
+        return to;
+    }
+
+    void destroy() noexcept {
+        if (!ptr) return;
+        if (relocate) ptr->~Base();
+        else delete ptr;
+    }
+
+    // 接管 other 的对象，other 置空
+    void take(InlinePtr& other) noexcept {
+        ptr = other.relocate ? other.relocate(storage, other.ptr) : other.ptr;
+        relocate = other.relocate;
+        other.ptr = nullptr;
+        other.relocate = nullptr;
+    }
+
+public:
+    // D 能否内联存放
+    template<typename D>
+    static constexpr bool fits = sizeof(D) <= Capacity && alignof(D) <= Align &&
+                                 std::is_nothrow_move_constructible_v<D>;
+
+    InlinePtr() noexcept
+        : ptr(nullptr), relocate(nullptr) {}
+
+    InlinePtr(std::nullptr_t) noexcept
+        : InlinePtr() {}
+
+    // 接管 UniquePtr 中的堆对象
+    template<typename D>
+        requires std::is_convertible_v<D*, Base*>
+    InlinePtr(UniquePtr<D>&& other) noexcept
+        : ptr(other.release()), relocate(nullptr) {}
+
+    InlinePtr(const InlinePtr&) = delete;
+    InlinePtr& operator=(const InlinePtr&) = delete;
+
+    // 内联对象随之移动（调用派生类的移动构造），堆对象只转移指针
+    InlinePtr(InlinePtr&& other) noexcept {
+        take(other);
+    }
+
+    InlinePtr& operator=(InlinePtr&& other) noexcept {
+        if (this != &other) {
+            destroy();
+            take(other);
+        }
+        return *this;
+    }
+
+    ~InlinePtr() noexcept {
+        destroy();
+    }
+
+    // 构造 D，放得下就内联，否则在堆上
+    template<typename D, typename... Args>
+        requires std::is_convertible_v<D*, Base*>
+    D& emplace(Args&&... args) {
+        reset();
+        if constexpr (fits<D>) {
+            D* p = ::new(static_cast<void*>(storage)) D(std::forward<Args>(args)...);
+            ptr = p;
+            relocate = &relocateAs<D>;
+            return *p;
+        } else {
+            D* p = new D(std::forward<Args>(args)...);
+            ptr = p;
+            return *p;
+        }
+    }
+
+    template<typename D, typename... Args>
+    static InlinePtr make(Args&&... args) {
+        InlinePtr p;
+        p.template emplace<D>(std::forward<Args>(args)...);
+        return p;
+    }
+
+    Base* get() const noexcept {
+        return ptr;
+    }
+
+    Base& operator*() const {
+        return *ptr;
+    }
+
+    Base* operator->() const noexcept {
+        return ptr;
+    }
+
+    explicit operator bool() const noexcept {
+        return ptr != nullptr;
+    }
+
+    // 对象是否存放在内部
+    bool isInline() const noexcept {
+        return relocate != nullptr;
+    }
+
+    void reset() noexcept {
+        destroy();
+        ptr = nullptr;
+        relocate = nullptr;
+    }
+};
+
+#endif // DAY2_INLINEPTR_H
@@ -0,0 +1,336 @@
+#ifndef DAY2_SHAREDPTR_H
+#define DAY2_SHAREDPTR_H
+// 模板类必须全部写在头文件中。
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// 引用计数策略
+// 原子计数：SharedPtr 可以跨线程拷贝、销毁
+struct AtomicRefCount {
+    std::atomic<long> value;
+
+    explicit AtomicRefCount(long initial = 1) noexcept
+        : value(initial) {}
+
+    void increment() noexcept {
+        // 新引用总是从已有引用复制而来，不需要同步
+        value.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 返回 true 表示这是最后一个引用
+    // acq_rel：其他持有者对对象的访问都发生在析构之前
+    bool decrement() noexcept {
+        return value.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+
+    long get() const noexcept {
+        return value.load(std::memory_order_relaxed);
+    }
+};
+
+// 非原子计数：只在单个线程内使用，省掉 lock 前缀指令
+struct LocalRefCount {
+    long value;
+
+    explicit LocalRefCount(long initial = 1) noexcept
+        : value(initial) {}
+
+    void increment() noexcept {
+        ++value;
+    }
+
+    bool decrement() noexcept {
+        return --value == 0;
+    }
+
+    long get() const noexcept {
+        return value;
+    }
+};
+
+// 控制块头：计数 + 销毁函数，销毁函数负责析构对象并释放整块内存
+template<typename Count>
+struct SharedControl {
+    Count refs;
+    void (*dispose)(SharedControl*) noexcept;
+};
+
+// 控制块头加上释放时要用的分配器；Allocator 为 void 时走全局 operator delete，不保存指针
+template<typename Count, typename Allocator>
+struct AllocatorControl : SharedControl<Count> {
+    Allocator* allocator;
+};
+
+template<typename Count>
+struct AllocatorControl<Count, void> : SharedControl<Count> {};
+
+// 控制块与对象放在同一次分配里
+// Allocator 为 void 时用全局 operator new，否则用分配器的 allocate / deallocate（如 PoolAllocator）
+template<typename T, typename Count, typename Allocator>
+struct SharedBlock : AllocatorControl<Count, Allocator> {
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    SharedBlock() noexcept requires std::is_void_v<Allocator>
+        : AllocatorControl<Count, Allocator>{{Count(1), &disposeBlock}} {}
+
+    explicit SharedBlock(Allocator* allocator) noexcept requires (!std::is_void_v<Allocator>)
+        : AllocatorControl<Count, Allocator>{{Count(1), &disposeBlock}, allocator} {}
+
+    T* object() noexcept {
+        return std::launder(reinterpret_cast<T*>(storage));
+    }
+
+    static void disposeBlock(SharedControl<Count>* control) noexcept {
+        auto* block = static_cast<SharedBlock*>(control);
+        block->object()->~T();
+        if constexpr (std::is_void_v<Allocator>) {
+            delete block;
+        } else {
+            Allocator* allocator = block->allocator;
+            block->~SharedBlock();
+            allocator->template deallocate<SharedBlock>(block, 1);
+        }
+    }
+};
+
+template<typename T, typename Count = AtomicRefCount>
+class SharedPtr {
+    template<typename U, typename C>
+    friend class SharedPtr;
+
+    T* ptr;
+    SharedControl<Count>* control;
+
+public:
+    // 接管控制块上一次已计入的引用，供 makeShared / allocateShared 使用
+    SharedPtr(T* ptr, SharedControl<Count>* control) noexcept
+        : ptr(ptr), control(control) {}
+
+    SharedPtr() noexcept
+        : ptr(nullptr), control(nullptr) {}
+
+    SharedPtr(std::nullptr_t) noexcept
+        : SharedPtr() {}
+
+    SharedPtr(const SharedPtr& other) noexcept
+        : ptr(other.ptr), control(other.control) {
+        if (control) control->refs.increment();
+    }
+
+    SharedPtr(SharedPtr&& other) noexcept
+        : ptr(other.ptr), control(other.control) {
+        other.ptr = nullptr;
+        other.control = nullptr;
+    }
+
+    // 派生类指针转换为基类指针
+    template<typename U>
+        requires std::is_convertible_v<U*, T*>
+    SharedPtr(const SharedPtr<U, Count>& other) noexcept
+        : ptr(other.ptr), control(other.control) {
+        if (control) control->refs.increment();
+    }
+
+    template<typename U>
+        requires std::is_convertible_v<U*, T*>
+    SharedPtr(SharedPtr<U, Count>&& other) noexcept
+        : ptr(other.ptr), control(other.control) {
+        other.ptr = nullptr;
+        other.control = nullptr;
+    }
+
+    // 先加后减，自赋值时不会提前销毁；reset 会清空 other 本身，先取出对方的指针
+    SharedPtr& operator=(const SharedPtr& other) noexcept {
+        T* new_ptr = other.ptr;
+        SharedControl<Count>* new_control = other.control;
+        if (new_control) new_control->refs.increment();
+        reset();
+        ptr = new_ptr;
+        control = new_control;
+        return *this;
+    }
+
+    SharedPtr& operator=(SharedPtr&& other) noexcept {
+        if (this != &other) {
+            reset();
+            ptr = other.ptr;
+            control = other.control;
+            other.ptr = nullptr;
+            other.control = nullptr;
+        }
+        return *this;
+    }
+
+    ~SharedPtr() noexcept {
+        reset();
+    }
+
+    T* get() const noexcept {
+        return ptr;
+    }
+
+    T& operator*() const {
+        return *ptr;
+    }
+
+    T* operator->() const noexcept {
+        return ptr;
+    }
+
+    explicit operator bool() const noexcept {
+        return ptr != nullptr;
+    }
+
+    long use_count() const noexcept {
+        return control ? control->refs.get() : 0;
+    }
+
+    void reset() noexcept {
+        if (control && control->refs.decrement()) control->dispose(control);
+        ptr = nullptr;
+        control = nullptr;
+    }
+};
+
+// 单线程热路径用的非原子版本，不能跨线程共享
+template<typename T>
+using LocalSharedPtr = SharedPtr<T, LocalRefCount>;
+
+// 一次分配同时放下控制块和对象
+template<typename T, typename Count = AtomicRefCount, typename... Args>
+SharedPtr<T, Count> makeShared(Args&&... args) {
+    using Block = SharedBlock<T, Count, void>;
+    auto* block = new Block();
+    try {
+        ::new(static_cast<void*>(block->storage)) T(std::forward<Args>(args)...);
+    } catch (...) {
+        delete block;
+        throw;
+    }
+    return SharedPtr<T, Count>(block->object(), block);
+}
+
+// 同上，内存来自分配器（如 PoolAllocator），最后一个引用释放时还给它
+// 分配器需比所有引用活得更久；PoolAllocator 只保证 16 字节对齐
+template<typename T, typename Count = AtomicRefCount, typename Allocator, typename... Args>
+SharedPtr<T, Count> allocateShared(Allocator& allocator, Args&&... args) {
+    using Block = SharedBlock<T, Count, Allocator>;
+    Block* memory = allocator.template allocate<Block>(1);
+    auto* block = ::new(static_cast<void*>(memory)) Block(&allocator);
+    try {
+        ::new(static_cast<void*>(block->storage)) T(std::forward<Args>(args)...);
+    } catch (...) {
+        block->~Block();
+        allocator.template deallocate<Block>(memory, 1);
+        throw;
+    }
+    return SharedPtr<T, Count>(block->object(), block);
+}
+
+// 侵入式引用计数基类：计数嵌在对象里，IntrusivePtr 只有一个指针大小，也不需要额外分配
+// 最后一个引用释放时 delete 对象；需要其他释放方式时自己提供 retain() / release()
+template<typename Derived, typename Count = AtomicRefCount>
+class RefCounted {
+    mutable Count refs{0};
+
+protected:
+    RefCounted() = default;
+    ~RefCounted() = default;
+
+public:
+    // 拷贝出来的新对象从 0 开始计数
+    RefCounted(const RefCounted&) noexcept {}
+    RefCounted& operator=(const RefCounted&) noexcept {
+        return *this;
+    }
+
+    void retain() const noexcept {
+        refs.increment();
+    }
+
+    void release() const noexcept {
+        if (refs.decrement()) delete static_cast<const Derived*>(this);
+    }
+
+    long use_count() const noexcept {
+        return refs.get();
+    }
+};
+
+// 指向自带计数对象的共享指针，T 需提供 retain() / release()
+template<typename T>
+class IntrusivePtr {
+    T* ptr;
+
+public:
+    IntrusivePtr() noexcept
+        : ptr(nullptr) {}
+
+    // 默认增加一次引用；retain 为 false 时接管调用方已持有的引用
+    explicit IntrusivePtr(T* ptr, bool retain = true) noexcept
+        : ptr(ptr) {
+        if (ptr && retain) ptr->retain();
+    }
+
+    IntrusivePtr(const IntrusivePtr& other) noexcept
+        : ptr(other.ptr) {
+        if (ptr) ptr->retain();
+    }
+
+    IntrusivePtr(IntrusivePtr&& other) noexcept
+        : ptr(other.ptr) {
+        other.ptr = nullptr;
+    }
+
+    IntrusivePtr& operator=(const IntrusivePtr& other) noexcept {
+        T* new_ptr = other.ptr;
+        if (new_ptr) new_ptr->retain();
+        reset();
+        ptr = new_ptr;
+        return *this;
+    }
+
+    IntrusivePtr& operator=(IntrusivePtr&& other) noexcept {
+        if (this != &other) {
+            reset();
+            ptr = other.ptr;
+            other.ptr = nullptr;
+        }
+        return *this;
+    }
+
+    ~IntrusivePtr() noexcept {
+        reset();
+    }
+
+    T* get() const noexcept {
+        return ptr;
+    }
+
+    T& operator*() const {
+        return *ptr;
+    }
+
+    T* operator->() const noexcept {
+        return ptr;
+    }
+
+    explicit operator bool() const noexcept {
+        return ptr != nullptr;
+    }
+
+    void reset() noexcept {
+        if (ptr) ptr->release();
+        ptr = nullptr;
+    }
+};
+
+template<typename T, typename... Args>
+IntrusivePtr<T> makeIntrusive(Args&&... args) {
+    return IntrusivePtr<T>(new T(std::forward<Args>(args)...));
+}
+
+#endif // DAY2_SHAREDPTR_H
@@ -1,19 +1,100 @@
 #ifndef DAY2_UNIQUEPTR_H
 #define DAY2_UNIQUEPTR_H
 // 模板类必须全部写在头文件中。
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
 
+// MSVC 需要自己的属性名，否则忽略 [[no_unique_address]]
+#if defined(_MSC_VER) && !defined(__clang__)
+#define UNIQUEPTR_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define UNIQUEPTR_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
+// 默认删除器：delete
+template<typename T>
+struct DefaultDelete {
+    void operator()(T* p) const noexcept {
+        static_assert(sizeof(T) > 0, "Cannot delete an incomplete type");
+        delete p;
+    }
+};
+
+// 数组版本：delete[]
 template<typename T>
+struct DefaultDelete<T[]> {
+    void operator()(T* p) const noexcept {
+        static_assert(sizeof(T) > 0, "Cannot delete an incomplete type");
+        delete[] p;
+    }
+};
+
+// 还给提供 allocate<T>(n) / deallocate<T>(p, n) 的分配器（如 Day5_ 的 PoolAllocator）
+// 对象需由 placement new 构造在 allocate<T>(1) 得到的内存上
+// 持有分配器指针，UniquePtr 因此多一个指针的大小
+template<typename T, typename Allocator>
+struct PoolDelete {
+    Allocator* allocator = nullptr;
+
+    void operator()(T* p) const {
+        p->~T();
+        allocator->template deallocate<T>(p, 1);
+    }
+};
+
+// 数组版本：记住元素个数，逐个析构后按同样的 n 归还
+template<typename T, typename Allocator>
+struct PoolDelete<T[], Allocator> {
+    Allocator* allocator = nullptr;
+    size_t count = 0;
+
+    void operator()(T* p) const {
+        for (size_t i = count; i > 0; --i) p[i - 1].~T();
+        allocator->template deallocate<T>(p, count);
+    }
+};
+
+// 同上，但分配器是全局对象、作为模板参数给出，删除器无状态，不占空间
+template<typename T, auto& allocator>
+struct GlobalPoolDelete {
+    void operator()(T* p) const {
+        p->~T();
+        allocator.template deallocate<T>(p, 1);
+    }
+};
+
+// 对象构造在池内缓冲区（如 Day1 的 Buffer）上：析构对象后放掉缓冲区句柄，由句柄归还 BufferPool
+// 句柄只能移动，删除器随 UniquePtr 一起移动
+template<typename T, typename Buffer>
+struct BufferDelete {
+    Buffer buffer;
+
+    void operator()(T* p) noexcept {
+        p->~T();
+        Buffer released = std::move(buffer);
+    }
+};
+
+template<typename T, typename Deleter = DefaultDelete<T>>
 class UniquePtr {
     T* ptr;
+    // 无状态删除器不占空间，sizeof(UniquePtr) == sizeof(T*)
+    UNIQUEPTR_NO_UNIQUE_ADDRESS Deleter deleter;
 
 public:
     // 默认构造
-    UniquePtr() noexcept
-        : ptr(nullptr) {}
+    UniquePtr() noexcept requires std::is_default_constructible_v<Deleter>
+        : ptr(nullptr), deleter() {}
 
     // 接管裸指针
-    explicit UniquePtr(T* ptr) noexcept
-        : ptr(ptr) {}
+    explicit UniquePtr(T* ptr) noexcept requires std::is_default_constructible_v<Deleter>
+        : ptr(ptr), deleter() {}
+
+    // 接管裸指针与有状态的删除器
+    UniquePtr(T* ptr, Deleter deleter) noexcept
+        : ptr(ptr), deleter(std::move(deleter)) {}
 
     // 禁止拷贝
     UniquePtr(const UniquePtr&) = delete;
@@ -22,23 +103,23 @@ public:
     // 移动构造
     // 移动构造不可能 self-move 故无需自检
     UniquePtr(UniquePtr&& other) noexcept
-        : ptr(other.ptr) {
+        : ptr(other.ptr), deleter(std::move(other.deleter)) {
         other.ptr = nullptr;
     }
 
     // 移动赋值
+    // 先用旧删除器释放旧对象，再接管对方的删除器
     UniquePtr& operator=(UniquePtr&& other) noexcept {
         if (this != &other) {
-            delete ptr;
-            ptr = other.ptr;
-            other.ptr = nullptr;
+            reset(other.release());
+            deleter = std::move(other.deleter);
         }
         return *this;
     }
 
     // 析构
     ~UniquePtr() noexcept {
-        delete ptr;
+        if (ptr) deleter(ptr);
     }
 
     // 访问接口
@@ -46,6 +127,14 @@ public:
         return ptr;
     }
 
+    Deleter& get_deleter() noexcept {
+        return deleter;
+    }
+
+    const Deleter& get_deleter() const noexcept {
+        return deleter;
+    }
+
     T& operator*() const {
         return *ptr;
     }
@@ -68,10 +157,137 @@ public:
 
     void reset(T* new_ptr = nullptr) noexcept {
         if (ptr != new_ptr) {
-            delete ptr;
+            // 先换上新指针再删除，删除器重入 reset 时也不会重复释放
+            T* old = ptr;
             ptr = new_ptr;
+            if (old) deleter(old);
         }
     }
 };
 
+// 数组特化：没有 * 和 ->，改用 operator[]
+template<typename T, typename Deleter>
+class UniquePtr<T[], Deleter> {
+    T* ptr;
+    UNIQUEPTR_NO_UNIQUE_ADDRESS Deleter deleter;
+
+public:
+    UniquePtr() noexcept requires std::is_default_constructible_v<Deleter>
+        : ptr(nullptr), deleter() {}
+
+    explicit UniquePtr(T* ptr) noexcept requires std::is_default_constructible_v<Deleter>
+        : ptr(ptr), deleter() {}
+
+    UniquePtr(T* ptr, Deleter deleter) noexcept
+        : ptr(ptr), deleter(std::move(deleter)) {}
+
+    UniquePtr(const UniquePtr&) = delete;
+    UniquePtr& operator=(const UniquePtr&) = delete;
+
+    UniquePtr(UniquePtr&& other) noexcept
+        : ptr(other.ptr), deleter(std::move(other.deleter)) {
+        other.ptr = nullptr;
+    }
+
+    UniquePtr& operator=(UniquePtr&& other) noexcept {
+        if (this != &other) {
+            reset(other.release());
+            deleter = std::move(other.deleter);
+        }
+        return *this;
+    }
+
+    ~UniquePtr() noexcept {
+        if (ptr) deleter(ptr);
+    }
+
+    T* get() const noexcept {
+        return ptr;
+    }
+
+    Deleter& get_deleter() noexcept {
+        return deleter;
+    }
+
+    const Deleter& get_deleter() const noexcept {
+        return deleter;
+    }
+
+    // 不检查越界
+    T& operator[](size_t i) const {
+        return ptr[i];
+    }
+
+    explicit operator bool() const noexcept {
+        return ptr != nullptr;
+    }
+
+    T* release() noexcept {
+        T* tmp = ptr;
+        ptr = nullptr;
+        return tmp;
+    }
+
+    void reset(T* new_ptr = nullptr) noexcept {
+        if (ptr != new_ptr) {
+            T* old = ptr;
+            ptr = new_ptr;
+            if (old) deleter(old);
+        }
+    }
+};
+
+// 堆上构造：makeUnique<T>(args...) 与 makeUnique<T[]>(n)（元素值初始化）
+template<typename T, typename... Args>
+    requires (!std::is_array_v<T>)
+UniquePtr<T> makeUnique(Args&&... args) {
+    return UniquePtr<T>(new T(std::forward<Args>(args)...));
+}
+
+template<typename T>
+    requires std::is_unbounded_array_v<T>
+UniquePtr<T> makeUnique(size_t n) {
+    return UniquePtr<T>(new std::remove_extent_t<T>[n]());
+}
+
+// 在分配器（如 PoolAllocator）的内存上构造，析构后还给同一个分配器
+// 构造抛异常时内存先归还再继续抛出
+template<typename T, typename Allocator, typename... Args>
+    requires (!std::is_array_v<T>)
+UniquePtr<T, PoolDelete<T, Allocator>> allocateUnique(Allocator& allocator, Args&&... args) {
+    T* memory = allocator.template allocate<T>(1);
+    try {
+        T* p = ::new(static_cast<void*>(memory)) T(std::forward<Args>(args)...);
+        return UniquePtr<T, PoolDelete<T, Allocator>>(p, PoolDelete<T, Allocator>{&allocator});
+    } catch (...) {
+        allocator.template deallocate<T>(memory, 1);
+        throw;
+    }
+}
+
+// 数组版本：n 个元素逐个值初始化，中途抛异常时析构已构造的部分
+template<typename T, typename Allocator>
+    requires std::is_unbounded_array_v<T>
+UniquePtr<T, PoolDelete<T, Allocator>> allocateUnique(Allocator& allocator, size_t n) {
+    using E = std::remove_extent_t<T>;
+    E* memory = allocator.template allocate<E>(n);
+    size_t built = 0;
+    try {
+        for (; built < n; ++built) ::new(static_cast<void*>(memory + built)) E();
+    } catch (...) {
+        while (built > 0) memory[--built].~E();
+        allocator.template deallocate<E>(memory, n);
+        throw;
+    }
+    return UniquePtr<T, PoolDelete<T, Allocator>>(memory, PoolDelete<T, Allocator>{&allocator, n});
+}
+
+// 在池内缓冲区上就地构造 T，返回的 UniquePtr 负责析构并归还缓冲区
+// 调用方保证缓冲区足够大且满足 T 的对齐
+template<typename T, typename Buffer, typename... Args>
+UniquePtr<T, BufferDelete<T, Buffer>> constructInBuffer(Buffer buffer, Args&&... args) {
+    T* p = ::new(static_cast<void*>(buffer.data())) T(std::forward<Args>(args)...);
+    return UniquePtr<T, BufferDelete<T, Buffer>>(p, BufferDelete<T, Buffer>{std::move(buffer)});
+}
+
 #endif // DAY2_UNIQUEPTR_H
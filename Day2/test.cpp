@@ -1,6 +1,17 @@
 #include <iostream>
 #include <cassert>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+#include <memory>
+#include <random>
+#include <thread>
 #include "UniquePtr.h"
+#include "SharedPtr.h"
+#include "AtomicUniquePtr.h"
+#include "InlinePtr.h"
+#include <shared_mutex>
 
 struct Counter {
     static int alive;
@@ -16,6 +27,448 @@ struct Counter {
 
 int Counter::alive = 0;
 
+// 与 PoolAllocator 相同接口的计数分配器
+struct CountingPool {
+    int allocated = 0;
+    int freed = 0;
+
+    template<typename T>
+    T* allocate(size_t n) {
+        ++allocated;
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    template<typename T>
+    void deallocate(T* p, size_t) {
+        ++freed;
+        ::operator delete(p);
+    }
+};
+
+CountingPool globalPool;
+
+// 与 Day1 Buffer 相同语义的只能移动的句柄：析构时归还
+struct MockBuffer {
+    static int returned;
+    alignas(16) static char storage[4][64];
+    char* ptr;
+
+    explicit MockBuffer(int slot) : ptr(storage[slot]) {}
+    MockBuffer(MockBuffer&& other) noexcept : ptr(other.ptr) { other.ptr = nullptr; }
+    MockBuffer& operator=(MockBuffer&& other) noexcept {
+        if (ptr) ++returned;
+        ptr = other.ptr;
+        other.ptr = nullptr;
+        return *this;
+    }
+    ~MockBuffer() { if (ptr) ++returned; }
+    char* data() const { return ptr; }
+};
+
+int MockBuffer::returned = 0;
+alignas(16) char MockBuffer::storage[4][64];
+
+template<typename F>
+double timeIt(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct Node : RefCounted<Node> {
+    static int alive;
+    int value;
+
+    explicit Node(int v) : value(v) {
+        ++alive;
+    }
+    ~Node() {
+        --alive;
+    }
+};
+
+int Node::alive = 0;
+
+struct Base {
+    virtual ~Base() = default;
+    virtual int id() const { return 1; }
+};
+
+struct Derived : Base {
+    int id() const override { return 2; }
+};
+
+void testSharedPtr() {
+    std::cout << "Running SharedPtr tests...\n";
+
+    // Test 1: 一次分配，拷贝共享，最后一个引用析构对象
+    {
+        auto p = makeShared<Counter>(1);
+        assert(p->value == 1 && p.use_count() == 1 && Counter::alive == 1);
+        {
+            SharedPtr<Counter> q = p;
+            SharedPtr<Counter> r;
+            r = q;
+            assert(p.use_count() == 3 && r.get() == p.get());
+            r = r;
+            assert(p.use_count() == 3);
+        }
+        assert(p.use_count() == 1);
+        SharedPtr<Counter> moved = std::move(p);
+        assert(!p && moved.use_count() == 1);
+        static_assert(sizeof(moved) == 2 * sizeof(void*));
+        // makeShared 的控制块不带分配器指针
+        static_assert(sizeof(SharedBlock<void*, AtomicRefCount, void>) == sizeof(SharedControl<AtomicRefCount>) + sizeof(void*));
+    }
+    assert(Counter::alive == 0);
+
+    // Test 2: 非原子计数
+    {
+        LocalSharedPtr<Counter> p = makeShared<Counter, LocalRefCount>(2);
+        LocalSharedPtr<Counter> q = p;
+        assert(q.use_count() == 2);
+        p.reset();
+        assert(q.use_count() == 1 && Counter::alive == 1);
+    }
+    assert(Counter::alive == 0);
+
+    // Test 3: 分配器内存，释放时归还
+    {
+        CountingPool pool;
+        {
+            auto p = allocateShared<Counter>(pool, 3);
+            auto q = p;
+            assert(q->value == 3 && pool.allocated == 1 && pool.freed == 0);
+        }
+        assert(Counter::alive == 0 && pool.freed == 1);
+    }
+
+    // Test 4: 派生类转基类
+    {
+        SharedPtr<Derived> d = makeShared<Derived>();
+        SharedPtr<Base> b = d;
+        assert(b->id() == 2 && d.use_count() == 2);
+        SharedPtr<Base> moved = std::move(d);
+        assert(!d && b.use_count() == 2);
+    }
+
+    // Test 5: 侵入式计数
+    {
+        auto p = makeIntrusive<Node>(5);
+        static_assert(sizeof(p) == sizeof(Node*));
+        assert(p->use_count() == 1 && Node::alive == 1);
+        IntrusivePtr<Node> q(p.get());
+        assert(p->use_count() == 2);
+        p.reset();
+        assert(q->value == 5 && q->use_count() == 1);
+    }
+    assert(Node::alive == 0);
+
+    // Test 6: 原子计数跨线程拷贝 / 销毁
+    {
+        auto p = makeShared<Counter>(6);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([p]() {
+                for (int i = 0; i < 10000; ++i) {
+                    SharedPtr<Counter> copy = p;
+                    assert(copy->value == 6);
+                }
+            });
+        }
+        for (auto& th : threads) th.join();
+        assert(p.use_count() == 1);
+    }
+    assert(Counter::alive == 0);
+
+    // Benchmark: 拷贝 + 销毁，对比 std::shared_ptr
+    {
+        constexpr int N = 1000000;
+        auto bench = [&](auto source) {
+            std::vector<decltype(source)> copies;
+            copies.reserve(N);
+            return timeIt([&] {
+                for (int i = 0; i < N; ++i) copies.push_back(source);
+                copies.clear();
+            });
+        };
+        auto create = [&](auto make) {
+            return timeIt([&] {
+                for (int i = 0; i < N; ++i) {
+                    auto p = make(i);
+                    assert(p);
+                }
+            });
+        };
+
+        CountingPool pool;
+        std::cout << "  copy + destroy x" << N << ":\n"
+                  << "    std::shared_ptr            " << bench(std::make_shared<int>(1)) << " ms\n"
+                  << "    SharedPtr (atomic)         " << bench(makeShared<int>(1)) << " ms\n"
+                  << "    SharedPtr (LocalRefCount)  " << bench(makeShared<int, LocalRefCount>(1)) << " ms\n"
+                  << "    IntrusivePtr               " << bench(makeIntrusive<Node>(1)) << " ms\n";
+        std::cout << "  create + destroy x" << N << ":\n"
+                  << "    std::make_shared           " << create([](int i) { return std::make_shared<int>(i); }) << " ms\n"
+                  << "    makeShared                 " << create([](int i) { return makeShared<int>(i); }) << " ms\n"
+                  << "    allocateShared (pool)      " << create([&](int i) { return allocateShared<int>(pool, i); }) << " ms\n";
+    }
+    assert(Node::alive == 0);
+
+    std::cout << "[OK] All SharedPtr tests passed\n";
+}
+
+// 路由表：所有项都等于 version，析构时写入毒值
+struct Table {
+    static std::atomic<int> alive;
+    int version;
+    std::vector<int> entries;
+
+    explicit Table(int v) : version(v), entries(64, v) {
+        alive.fetch_add(1);
+    }
+    ~Table() {
+        for (auto& e : entries) e = -1;
+        version = -1;
+        alive.fetch_sub(1);
+    }
+};
+
+std::atomic<int> Table::alive{0};
+
+void testAtomicUniquePtr() {
+    std::cout << "Running AtomicUniquePtr tests...\n";
+    EpochDomain& domain = EpochDomain::instance();
+
+    // Test 1: 发布与读取，旧对象在读者离开后才销毁
+    {
+        AtomicUniquePtr<Table> table(makeUnique<Table>(1));
+        {
+            auto guard = table.read();
+            assert(guard->version == 1);
+
+            table.store(makeUnique<Table>(2));
+            // 读者仍持有旧表
+            assert(guard->version == 1 && guard->entries[63] == 1);
+            assert(Table::alive == 2 && domain.pending() == 1);
+            {
+                // 嵌套读看到新表
+                auto inner = table.read();
+                assert(inner->version == 2);
+            }
+        }
+        domain.synchronize();
+        assert(Table::alive == 1 && domain.pending() == 0);
+
+        table.reset();
+        domain.synchronize();
+        assert(!table.read() && Table::alive == 0);
+    }
+
+    // Test 2: 一个写者不断发布，多个读者并发读取，不会读到已销毁的表
+    {
+        AtomicUniquePtr<Table> table(makeUnique<Table>(0));
+        std::atomic<bool> stop{false};
+        std::atomic<bool> corrupted{false};
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t) {
+            readers.emplace_back([&]() {
+                while (!stop.load(std::memory_order_relaxed)) {
+                    auto guard = table.read();
+                    int v = guard->version;
+                    for (int e : guard->entries) {
+                        if (e != v || v < 0) corrupted = true;
+                    }
+                }
+            });
+        }
+        for (int v = 1; v <= 2000; ++v) table.store(makeUnique<Table>(v));
+        stop = true;
+        for (auto& th : readers) th.join();
+        assert(!corrupted);
+    }
+    domain.synchronize();
+    assert(Table::alive == 0);
+
+    // Benchmark: 1 个写者 + N 个读者，对比 shared_mutex
+    {
+        constexpr auto duration = std::chrono::milliseconds(200);
+        unsigned max_readers = std::max(8u, std::thread::hardware_concurrency());
+        for (unsigned n = 1; n <= max_readers; n *= 2) {
+            auto run = [&](auto&& read, auto&& write) {
+                std::atomic<bool> stop{false};
+                std::atomic<long long> reads{0};
+                std::vector<std::thread> threads;
+                for (unsigned t = 0; t < n; ++t) {
+                    threads.emplace_back([&]() {
+                        long long local = 0;
+                        long long sum = 0;
+                        while (!stop.load(std::memory_order_relaxed)) {
+                            sum += read();
+                            ++local;
+                        }
+                        reads += local + (sum == 42);
+                    });
+                }
+                threads.emplace_back([&]() {
+                    for (int v = 1; !stop.load(std::memory_order_relaxed); ++v) {
+                        write(v);
+                        std::this_thread::sleep_for(std::chrono::microseconds(100));
+                    }
+                });
+                std::this_thread::sleep_for(duration);
+                stop = true;
+                for (auto& th : threads) th.join();
+                return static_cast<long long>(reads / std::chrono::duration<double>(duration).count());
+            };
+
+            AtomicUniquePtr<Table> table(makeUnique<Table>(0));
+            long long ebr = run([&] { auto guard = table.read(); return guard->entries[7]; },
+                                [&](int v) { table.store(makeUnique<Table>(v)); });
+
+            std::shared_mutex mtx;
+            auto locked = std::make_unique<Table>(0);
+            long long rw = run([&] { std::shared_lock lock(mtx); return locked->entries[7]; },
+                               [&](int v) {
+                                   auto next = std::make_unique<Table>(v);
+                                   std::unique_lock lock(mtx);
+                                   locked = std::move(next);
+                               });
+            std::cout << "  " << n << " readers: EBR " << ebr << " reads/s, shared_mutex " << rw << " reads/s\n";
+        }
+    }
+    domain.synchronize();
+    assert(Table::alive == 0);
+
+    std::cout << "[OK] All AtomicUniquePtr tests passed\n";
+}
+
+struct Shape {
+    static int alive;
+    Shape() { ++alive; }
+    Shape(const Shape&) noexcept { ++alive; }
+    virtual ~Shape() { --alive; }
+    virtual double area() const = 0;
+};
+
+int Shape::alive = 0;
+
+struct Square : Shape {
+    double side;
+    explicit Square(double s) : side(s) {}
+    double area() const override { return side * side; }
+};
+
+struct Circle : Shape {
+    double radius;
+    explicit Circle(double r) : radius(r) {}
+    double area() const override { return 3.0 * radius * radius; }
+};
+
+// 放不进内联存储
+struct Polygon : Shape {
+    double points[16] = {};
+    explicit Polygon(double v) { points[15] = v; }
+    double area() const override { return points[15]; }
+};
+
+void testInlinePtr() {
+    std::cout << "Running InlinePtr tests...\n";
+    using ShapePtr = InlinePtr<Shape, 24>;
+
+    // Test 1: 小对象内联，大对象退回堆上，调用仍走虚函数
+    {
+        static_assert(ShapePtr::fits<Square> && !ShapePtr::fits<Polygon>);
+        auto square = ShapePtr::make<Square>(2.0);
+        auto polygon = ShapePtr::make<Polygon>(7.0);
+        assert(square.isInline() && !polygon.isInline());
+        assert(square->area() == 4.0 && polygon->area() == 7.0);
+        assert(reinterpret_cast<const void*>(square.get()) >= static_cast<const void*>(&square) &&
+               reinterpret_cast<const void*>(square.get()) < static_cast<const void*>(&square + 1));
+        assert(Shape::alive == 2);
+    }
+    assert(Shape::alive == 0);
+
+    // Test 2: 移动时内联对象跟着搬家
+    {
+        std::vector<ShapePtr> shapes;
+        for (int i = 0; i < 100; ++i) {
+            if (i % 3 == 0) shapes.push_back(ShapePtr::make<Circle>(1.0));
+            else if (i % 3 == 1) shapes.push_back(ShapePtr::make<Square>(1.0));
+            else shapes.push_back(ShapePtr::make<Polygon>(1.0));
+        }
+        // vector 扩容搬动过多次
+        double total = 0;
+        for (auto& s : shapes) total += s->area();
+        assert(total == 34 * 3.0 + 33 + 33);
+        assert(Shape::alive == 100);
+
+        ShapePtr moved = std::move(shapes[0]);
+        assert(!shapes[0] && moved->area() == 3.0);
+        shapes[1] = std::move(moved);
+        assert(!moved && shapes[1]->area() == 3.0 && Shape::alive == 99);
+
+        shapes[2].emplace<Square>(3.0);
+        assert(shapes[2].isInline() && shapes[2]->area() == 9.0);
+        shapes[2].reset();
+        assert(!shapes[2] && Shape::alive == 98);
+    }
+    assert(Shape::alive == 0);
+
+    // Test 3: 接管 UniquePtr
+    {
+        ShapePtr p = makeUnique<Circle>(2.0);
+        assert(!p.isInline() && p->area() == 12.0);
+    }
+    assert(Shape::alive == 0);
+
+    // Benchmark: 构造 + 遍历一组多态对象
+    {
+        constexpr int N = 1000000;
+        double sumUnique = 0, sumInline = 0;
+        std::vector<std::unique_ptr<Shape>> heap;
+        std::vector<ShapePtr> inlined;
+        heap.reserve(N);
+        inlined.reserve(N);
+
+        double buildUnique = timeIt([&] {
+            for (int i = 0; i < N; ++i) {
+                if (i & 1) heap.push_back(std::make_unique<Square>(i));
+                else heap.push_back(std::make_unique<Circle>(i));
+            }
+        });
+        double buildInline = timeIt([&] {
+            for (int i = 0; i < N; ++i) {
+                if (i & 1) inlined.push_back(ShapePtr::make<Square>(i));
+                else inlined.push_back(ShapePtr::make<Circle>(i));
+            }
+        });
+        double iterUnique = timeIt([&] {
+            for (int r = 0; r < 10; ++r) for (auto& s : heap) sumUnique += s->area();
+        });
+        double iterInline = timeIt([&] {
+            for (int r = 0; r < 10; ++r) for (auto& s : inlined) sumInline += s->area();
+        });
+        assert(sumUnique == sumInline);
+
+        // 打乱顺序（排序、增删之后的常态）：堆对象的访问随之变得离散，内联对象跟着元素搬动仍然连续
+        std::shuffle(heap.begin(), heap.end(), std::mt19937(42));
+        std::shuffle(inlined.begin(), inlined.end(), std::mt19937(42));
+        double shuffledUnique = timeIt([&] {
+            for (int r = 0; r < 10; ++r) for (auto& s : heap) sumUnique += s->area();
+        });
+        double shuffledInline = timeIt([&] {
+            for (int r = 0; r < 10; ++r) for (auto& s : inlined) sumInline += s->area();
+        });
+        assert(sumUnique == sumInline);
+        std::cout << "  build x" << N << ": unique_ptr " << buildUnique << " ms, InlinePtr " << buildInline << " ms\n"
+                  << "  iterate x10:     unique_ptr " << iterUnique << " ms, InlinePtr " << iterInline << " ms\n"
+                  << "  shuffled x10:    unique_ptr " << shuffledUnique << " ms, InlinePtr " << shuffledInline << " ms\n";
+    }
+    assert(Shape::alive == 0);
+
+    std::cout << "[OK] All InlinePtr tests passed\n";
+}
+
 int main() {
     std::cout << "Running UniquePtr tests...\n";
 
@@ -99,6 +552,147 @@ int main() {
         }
     }
 
+    // Test 9: 无状态删除器不增加大小
+    {
+        static_assert(sizeof(UniquePtr<int>) == sizeof(int*));
+        static_assert(sizeof(UniquePtr<int, GlobalPoolDelete<int, globalPool>>) == sizeof(int*));
+        static_assert(sizeof(UniquePtr<int, PoolDelete<int, CountingPool>>) == 2 * sizeof(int*));
+    }
+
+    // Test 10: 还给分配器
+    {
+        CountingPool pool;
+        {
+            Counter* raw = new (pool.allocate<Counter>(1)) Counter(3);
+            UniquePtr<Counter, PoolDelete<Counter, CountingPool>> p(raw, {&pool});
+            assert(p->value == 3 && Counter::alive == 1);
+            assert(p.get_deleter().allocator == &pool);
+
+            UniquePtr<Counter, PoolDelete<Counter, CountingPool>> q(std::move(p));
+            assert(!p && q);
+        }
+        assert(Counter::alive == 0);
+        assert(pool.allocated == 1 && pool.freed == 1);
+
+        {
+            UniquePtr<Counter, GlobalPoolDelete<Counter, globalPool>> p(new (globalPool.allocate<Counter>(1)) Counter(4));
+            p.reset(new (globalPool.allocate<Counter>(1)) Counter(5));
+            assert(p->value == 5 && globalPool.freed == 1);
+        }
+        assert(Counter::alive == 0 && globalPool.freed == 2);
+    }
+
+    // Test 11: 移动赋值时旧对象用旧删除器释放
+    {
+        CountingPool a, b;
+        UniquePtr<int, PoolDelete<int, CountingPool>> pa(new (a.allocate<int>(1)) int(1), {&a});
+        UniquePtr<int, PoolDelete<int, CountingPool>> pb(new (b.allocate<int>(1)) int(2), {&b});
+        pa = std::move(pb);
+        assert(a.freed == 1 && b.freed == 0);
+        assert(*pa == 2 && pa.get_deleter().allocator == &b);
+        pa.reset();
+        assert(b.freed == 1);
+    }
+
+    // Test 12: 构造在池内缓冲区上，最后归还缓冲区
+    {
+        {
+            auto p = constructInBuffer<Counter>(MockBuffer(0), 9);
+            assert(p->value == 9 && Counter::alive == 1);
+            assert(reinterpret_cast<char*>(p.get()) == MockBuffer::storage[0]);
+
+            auto q = std::move(p);
+            assert(MockBuffer::returned == 0);
+        }
+        assert(Counter::alive == 0 && MockBuffer::returned == 1);
+    }
+
+    // Test 13: 数组特化
+    {
+        UniquePtr<int[]> a(new int[4]{1, 2, 3, 4});
+        assert(a[2] == 3);
+        a[2] = 30;
+        assert(a.get()[2] == 30);
+        static_assert(sizeof(a) == sizeof(int*));
+
+        {
+            UniquePtr<Counter[]> c(new Counter[3]{Counter(1), Counter(2), Counter(3)});
+            assert(Counter::alive == 3 && c[1].value == 2);
+            c.reset(new Counter[1]{Counter(9)});
+            assert(Counter::alive == 1);
+        }
+        assert(Counter::alive == 0);
+
+        auto zeros = makeUnique<double[]>(8);
+        for (int i = 0; i < 8; ++i) assert(zeros[i] == 0.0);
+    }
+
+    // Test 14: makeUnique / allocateUnique
+    {
+        auto p = makeUnique<Counter>(11);
+        assert(p->value == 11 && Counter::alive == 1);
+        p.reset();
+
+        CountingPool pool;
+        {
+            auto q = allocateUnique<Counter>(pool, 12);
+            static_assert(std::is_same_v<decltype(q), UniquePtr<Counter, PoolDelete<Counter, CountingPool>>>);
+            assert(q->value == 12 && Counter::alive == 1 && pool.allocated == 1);
+
+            auto arr = allocateUnique<int[]>(pool, 16);
+            for (int i = 0; i < 16; ++i) assert(arr[i] == 0);
+            assert(arr.get_deleter().count == 16 && pool.allocated == 2);
+        }
+        assert(Counter::alive == 0 && pool.freed == 2);
+
+        // 构造抛异常时内存归还
+        struct Throwing {
+            Throwing() { throw std::runtime_error("ctor"); }
+        };
+        bool thrown = false;
+        try { auto t = allocateUnique<Throwing>(pool); } catch (const std::runtime_error&) { thrown = true; }
+        assert(thrown && pool.allocated == 3 && pool.freed == 3);
+    }
+
+    // Benchmark: 与裸指针对比
+    {
+        constexpr int N = 1000000;
+        std::vector<int*> raws(N);
+        std::vector<UniquePtr<int>> owners(N);
+
+        using PoolPtr = UniquePtr<int, GlobalPoolDelete<int, globalPool>>;
+        std::vector<PoolPtr> poolOwners(N);
+
+        auto rawNew = [&] {
+            for (int i = 0; i < N; ++i) raws[i] = new int(i);
+            for (int i = 0; i < N; ++i) delete raws[i];
+        };
+        auto uniqueNew = [&] {
+            for (int i = 0; i < N; ++i) owners[i] = UniquePtr<int>(new int(i));
+            for (int i = 0; i < N; ++i) owners[i].reset();
+        };
+        auto rawPool = [&] {
+            for (int i = 0; i < N; ++i) raws[i] = new (globalPool.allocate<int>(1)) int(i);
+            for (int i = 0; i < N; ++i) globalPool.deallocate(raws[i], 1);
+        };
+        auto uniquePool = [&] {
+            for (int i = 0; i < N; ++i) poolOwners[i] = PoolPtr(new (globalPool.allocate<int>(1)) int(i));
+            for (int i = 0; i < N; ++i) poolOwners[i].reset();
+        };
+        // 先各跑一遍预热堆
+        rawNew();
+        uniqueNew();
+
+        std::cout << "  sizeof: int* " << sizeof(int*) << ", UniquePtr<int> " << sizeof(UniquePtr<int>)
+                  << ", UniquePtr<int, GlobalPoolDelete> " << sizeof(PoolPtr) << "\n";
+        std::cout << "  new/delete  raw " << timeIt(rawNew) << " ms, UniquePtr " << timeIt(uniqueNew) << " ms\n";
+        std::cout << "  pool        raw " << timeIt(rawPool) << " ms, UniquePtr " << timeIt(uniquePool) << " ms\n";
+    }
+
     std::cout << "[OK] All UniquePtr tests passed\n";
+
+    testSharedPtr();
+    testAtomicUniquePtr();
+    testInlinePtr();
     return 0;
 }
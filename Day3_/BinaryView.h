@@ -0,0 +1,215 @@
+//
+// Created by Ayr on 2025/12/23.
+//
+
+#ifndef DAY3__BINARYVIEW_H
+#define DAY3__BINARYVIEW_H
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "Serializer.h"
+
+// 成员指针在 StructFields() 里的下标，找不到时为字段数
+template<class T, auto Member>
+constexpr size_t fieldIndex() {
+    size_t index = std::tuple_size_v<decltype(T::StructFields())>;
+    forEachField<T>([&](const auto &field, size_t i) {
+        if constexpr (std::is_same_v<decltype(field.member), decltype(Member)>) {
+            if (field.member == Member) index = i;
+        }
+    });
+    return index;
+}
+
+// M 能否出现在 BinaryView 里：各级嵌套对象都要有编译期描述，不能是 Serializable
+// 只用于检查不占字节的元素，这类元素不会经由 vector / map 递归到自身
+template<class M>
+constexpr bool viewableField() {
+    if constexpr (std::same_as<M, std::string> || std::floating_point<M> || (std::integral<M> && !std::same_as<M, bool>)) {
+        return true;
+    }
+    else if constexpr (isVector<M> || isArray<M> || isOptional<M>) {
+        return viewableField<typename M::value_type>();
+    }
+    else if constexpr (isMap<M>) {
+        return viewableField<typename M::key_type>() && viewableField<typename M::mapped_type>();
+    }
+    else if constexpr (Reflectable<M>) {
+        bool ok = true;
+        forEachField<M>([&](const auto &field, size_t) {
+            ok = ok && viewableField<std::remove_cvref_t<decltype(std::declval<const M &>().*field.member)>>();
+        });
+        return ok;
+    }
+    else {
+        return false;
+    }
+}
+
+// BinaryFormat 消息的只读视图：构造时扫描一遍，记下每个字段的起始偏移，之后按下标直接定位
+// 不构造 T，也不拷贝：字符串字段是指向输入的 string_view，数字在访问时才解码，嵌套对象是子视图
+// Source 为 std::string_view 时不持有输入；否则持有 Source（如 Day1 的 Buffer / SharedBuffer，
+// 需可移动并提供 data()），视图存活期间输入不会被释放或还回池中
+// 只支持各级嵌套对象都有编译期描述的类型
+template<Reflectable T, class Source = std::string_view>
+class BinaryView {
+    static constexpr size_t num = std::tuple_size_v<decltype(T::StructFields())>;
+
+    template<size_t I>
+    using FieldType = std::remove_cvref_t<decltype(std::declval<const T &>().*(std::get<I>(T::StructFields()).member))>;
+
+    Source source;
+    size_t length;
+    // offsets[i] 为第 i 个字段的起始偏移，offsets[num] 为整条消息的长度
+    std::array<size_t, num + 1> offsets{};
+
+    // 跳过一个字段，只检查边界与编码，不做数值范围检查
+    template<class M>
+    static void skip(BinaryReader &reader) {
+        if constexpr (std::same_as<M, std::string>) {
+            reader.string();
+        }
+        else if constexpr (std::floating_point<M>) {
+            reader.take(8);
+        }
+        else if constexpr (std::integral<M> && !std::same_as<M, bool>) {
+            reader.varint();
+        }
+        else if constexpr (isVector<M> || isArray<M>) {
+            using E = typename M::value_type;
+            size_t count;
+            if constexpr (isVector<M>) count = reader.count(minElementSize<E>());
+            else count = std::tuple_size_v<M>;
+            if constexpr (bulkCopyable<E>) {
+                reader.take(count * sizeof(E));
+            }
+            else if constexpr (minElementSize<E>() > 0) {
+                for (size_t i = 0; i < count; i++) skip<E>(reader);
+            }
+            else {
+                // 只含 Reflectable 类型时，最小为 0 字节的元素必然不占字节，不用逐个跳过；
+                // Serializable 的最小长度也按 0 计，要先排除
+                static_assert(viewableField<E>(), "BinaryView requires every nested field to be Reflectable");
+            }
+        }
+        else if constexpr (isMap<M>) {
+            using K = typename M::key_type;
+            using V = typename M::mapped_type;
+            size_t count = reader.count(minBinarySize<K>() + minBinarySize<V>());
+            if constexpr (minBinarySize<K>() + minBinarySize<V>() > 0) {
+                for (size_t i = 0; i < count; i++) {
+                    skip<K>(reader);
+                    skip<V>(reader);
+                }
+            }
+            else {
+                static_assert(viewableField<K>() && viewableField<V>(),
+                              "BinaryView requires every nested field to be Reflectable");
+            }
+        }
+        else if constexpr (isOptional<M>) {
+            char flag = *reader.take(1);
+            if (flag == 1) skip<typename M::value_type>(reader);
+            else if (flag != 0) throw std::invalid_argument{"Invalid optional flag"};
+        }
+        else if constexpr (Reflectable<M>) {
+            forEachField<M>([&](const auto &field, size_t) {
+                skip<std::remove_cvref_t<decltype(std::declval<const M &>().*field.member)>>(reader);
+            });
+        }
+        else {
+            static_assert(unsupportedField<M>, "BinaryView requires every nested field to be Reflectable");
+        }
+    }
+
+    // 从 bytes 开头建立索引，返回这个对象占用的字节数
+    size_t index(std::string_view bytes) {
+        BinaryReader reader{bytes.data(), bytes.size()};
+        forEachField<T>([&](const auto &field, size_t i) {
+            offsets[i] = reader.position() - bytes.data();
+            skip<std::remove_cvref_t<decltype(std::declval<const T &>().*field.member)>>(reader);
+        });
+        offsets[num] = reader.position() - bytes.data();
+        return offsets[num];
+    }
+
+    template<Reflectable, class>
+    friend class BinaryView;
+
+    // 嵌套子视图：不持有输入，只截取父视图里的一段
+    struct Nested {};
+
+    BinaryView(Nested, std::string_view bytes) requires std::same_as<Source, std::string_view>
+        : source(bytes), length(0) {
+        length = index(bytes);
+    }
+
+    public:
+    // 不持有输入，调用方保证 bytes 比视图活得久；多余的字节视为格式错误
+    explicit BinaryView(std::string_view bytes) requires std::same_as<Source, std::string_view>
+        : source(bytes), length(bytes.size()) {
+        if (index(bytes) != length) throw std::invalid_argument{"Trailing bytes after object"};
+    }
+
+    // 持有 source，消息为 source.data() 开头的 size 字节
+    BinaryView(Source source, size_t size) requires (!std::same_as<Source, std::string_view>)
+        : source(std::move(source)), length(size) {
+        if (index(bytes()) != length) throw std::invalid_argument{"Trailing bytes after object"};
+    }
+
+    // 整条消息；每次从 source 取地址，视图被移动后依然有效
+    [[nodiscard]] std::string_view bytes() const {
+        if constexpr (std::same_as<Source, std::string_view>) return source.substr(0, length);
+        else return {source.data(), length};
+    }
+
+    // 第 I 个字段的原始编码
+    template<size_t I>
+    [[nodiscard]] std::string_view raw() const {
+        return bytes().substr(offsets[I], offsets[I + 1] - offsets[I]);
+    }
+
+    // 按下标或成员指针访问：view.get<0>()、view.get<&Person::name>()
+    // 字符串 → string_view，数字 → 现场解码，嵌套对象 → BinaryView<M>（不持有输入，不能比本视图活得久），
+    // 容器 → 解码出一份拷贝
+    template<auto Key>
+    [[nodiscard]] auto get() const {
+        if constexpr (std::is_member_object_pointer_v<decltype(Key)>) {
+            constexpr size_t I = fieldIndex<T, Key>();
+            static_assert(I < num, "Member is not listed in StructFields()");
+            return get<I>();
+        }
+        else {
+            static_assert(Key < num, "Field index out of range");
+            using M = FieldType<Key>;
+            std::string_view field = raw<Key>();
+            BinaryReader reader{field.data(), field.size()};
+            if constexpr (std::same_as<M, std::string>) {
+                return reader.string();
+            }
+            else if constexpr (std::floating_point<M>) {
+                return static_cast<M>(reader.float64());
+            }
+            else if constexpr (std::integral<M>) {
+                return reader.integer<M>();
+            }
+            else if constexpr (Reflectable<M>) {
+                return BinaryView<M>(typename BinaryView<M>::Nested{}, field);
+            }
+            else {
+                M value{};
+                Serializer<BinaryFormat>::readBinary(reader, value);
+                return value;
+            }
+        }
+    }
+
+    // 需要完整对象时再解码
+    [[nodiscard]] T materialize() const {
+        return Serializer<BinaryFormat>().template deserialize<T>(bytes());
+    }
+};
+
+#endif //DAY3__BINARYVIEW_H
@@ -0,0 +1,223 @@
+//
+// Created by Ayr on 2025/12/23.
+//
+
+#include "JSONScan.h"
+#include <algorithm>
+#include <bit>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define JSONSCAN_SSE2 1
+#include <emmintrin.h>
+// AVX2 版本依赖 GCC / Clang 的 target 属性与 __builtin_cpu_supports，整个文件不需要 -mavx2
+#if defined(__GNUC__)
+#define JSONSCAN_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+namespace {
+
+bool isEscape(unsigned char c) {
+    return c == '"' || c == '\\' || c < 0x20;
+}
+
+bool isQuote(unsigned char c) {
+    return c == '"' || c == '\\';
+}
+
+bool isStructural(unsigned char c) {
+    return c == '"' || c == '\\' || c == '{' || c == '}' || c == '[' || c == ']';
+}
+
+template<bool (*match)(unsigned char)>
+size_t scalarFind(const char *p, size_t i, size_t n) {
+    for (; i < n; i++) {
+        if (match(static_cast<unsigned char>(p[i]))) return i;
+    }
+    return n;
+}
+
+size_t findEscapeScalar(const char *p, size_t n) {
+    return scalarFind<isEscape>(p, 0, n);
+}
+
+size_t findQuoteScalar(const char *p, size_t n) {
+    return scalarFind<isQuote>(p, 0, n);
+}
+
+size_t findStructuralScalar(const char *p, size_t n) {
+    return scalarFind<isStructural>(p, 0, n);
+}
+
+#ifdef JSONSCAN_SSE2
+// 每个函数把 16 字节映射成命中位图，主循环共用；不足 16 字节的尾部交给标量
+template<int (*mask)(__m128i), bool (*match)(unsigned char)>
+size_t sse2Find(const char *p, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        int bits = mask(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i)));
+        if (bits) return i + std::countr_zero(static_cast<unsigned>(bits));
+    }
+    return scalarFind<match>(p, i, n);
+}
+
+int escapeMask128(__m128i v) {
+    // 无符号 v <= 0x1f 等价于 max(v, 0x1f) == 0x1f
+    __m128i control = _mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(0x1f)), _mm_set1_epi8(0x1f));
+    __m128i quote = _mm_cmpeq_epi8(v, _mm_set1_epi8('"'));
+    __m128i backslash = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+    return _mm_movemask_epi8(_mm_or_si128(control, _mm_or_si128(quote, backslash)));
+}
+
+int quoteMask128(__m128i v) {
+    __m128i quote = _mm_cmpeq_epi8(v, _mm_set1_epi8('"'));
+    __m128i backslash = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+    return _mm_movemask_epi8(_mm_or_si128(quote, backslash));
+}
+
+int structuralMask128(__m128i v) {
+    // '{' 与 '[' 只差 0x20，'}' 与 ']' 同理：或上 0x20 后各比较一次
+    __m128i folded = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    __m128i open = _mm_cmpeq_epi8(folded, _mm_set1_epi8('{'));
+    __m128i close = _mm_cmpeq_epi8(folded, _mm_set1_epi8('}'));
+    __m128i quote = _mm_cmpeq_epi8(v, _mm_set1_epi8('"'));
+    __m128i backslash = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+    return _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(open, close), _mm_or_si128(quote, backslash)));
+}
+
+size_t findEscapeSSE2(const char *p, size_t n) {
+    return sse2Find<escapeMask128, isEscape>(p, n);
+}
+
+size_t findQuoteSSE2(const char *p, size_t n) {
+    return sse2Find<quoteMask128, isQuote>(p, n);
+}
+
+size_t findStructuralSSE2(const char *p, size_t n) {
+    return sse2Find<structuralMask128, isStructural>(p, n);
+}
+#endif
+
+#ifdef JSONSCAN_AVX2
+// 与 SSE2 版本相同，一次 32 字节；剩下不足 32 字节时交给 SSE2 版本
+// 调 SSE2 版本前必须先 vzeroupper，否则 ymm 高半部分是脏的，传统 SSE 指令会付出很大的切换代价
+#define JSONSCAN_AVX2_TARGET __attribute__((target("avx2")))
+
+JSONSCAN_AVX2_TARGET unsigned escapeMask256(__m256i v) {
+    __m256i control = _mm256_cmpeq_epi8(_mm256_max_epu8(v, _mm256_set1_epi8(0x1f)), _mm256_set1_epi8(0x1f));
+    __m256i quote = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'));
+    __m256i backslash = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'));
+    return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(control, _mm256_or_si256(quote, backslash))));
+}
+
+JSONSCAN_AVX2_TARGET unsigned quoteMask256(__m256i v) {
+    __m256i quote = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'));
+    __m256i backslash = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'));
+    return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(quote, backslash)));
+}
+
+JSONSCAN_AVX2_TARGET unsigned structuralMask256(__m256i v) {
+    __m256i folded = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    __m256i open = _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{'));
+    __m256i close = _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}'));
+    __m256i quote = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'));
+    __m256i backslash = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'));
+    return static_cast<unsigned>(_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_or_si256(open, close), _mm256_or_si256(quote, backslash))));
+}
+
+JSONSCAN_AVX2_TARGET size_t findEscapeAVX2(const char *p, size_t n) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        unsigned bits = escapeMask256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i)));
+        if (bits) return i + std::countr_zero(bits);
+    }
+    _mm256_zeroupper();
+    return i + findEscapeSSE2(p + i, n - i);
+}
+
+JSONSCAN_AVX2_TARGET size_t findQuoteAVX2(const char *p, size_t n) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        unsigned bits = quoteMask256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i)));
+        if (bits) return i + std::countr_zero(bits);
+    }
+    _mm256_zeroupper();
+    return i + findQuoteSSE2(p + i, n - i);
+}
+
+JSONSCAN_AVX2_TARGET size_t findStructuralAVX2(const char *p, size_t n) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        unsigned bits = structuralMask256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i)));
+        if (bits) return i + std::countr_zero(bits);
+    }
+    _mm256_zeroupper();
+    return i + findStructuralSSE2(p + i, n - i);
+}
+#endif
+
+struct Kernels {
+    JSONScan::Level level;
+    size_t (*findEscape)(const char *, size_t);
+    size_t (*findQuote)(const char *, size_t);
+    size_t (*findStructural)(const char *, size_t);
+};
+
+Kernels kernelsFor(JSONScan::Level level) {
+    switch (level) {
+#ifdef JSONSCAN_AVX2
+        case JSONScan::Level::AVX2:
+            return {level, findEscapeAVX2, findQuoteAVX2, findStructuralAVX2};
+#endif
+#ifdef JSONSCAN_SSE2
+        case JSONScan::Level::SSE2:
+            return {level, findEscapeSSE2, findQuoteSSE2, findStructuralSSE2};
+#endif
+        default:
+            return {JSONScan::Level::Scalar, findEscapeScalar, findQuoteScalar, findStructuralScalar};
+    }
+}
+
+JSONScan::Level detect() {
+#ifdef JSONSCAN_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return JSONScan::Level::AVX2;
+#endif
+#ifdef JSONSCAN_SSE2
+    // x86-64 必定支持 SSE2
+    return JSONScan::Level::SSE2;
+#else
+    return JSONScan::Level::Scalar;
+#endif
+}
+
+const JSONScan::Level best = detect();
+Kernels active = kernelsFor(best);
+
+}
+
+size_t JSONScan::findEscape(const char *p, size_t n) {
+    return active.findEscape(p, n);
+}
+
+size_t JSONScan::findQuote(const char *p, size_t n) {
+    return active.findQuote(p, n);
+}
+
+size_t JSONScan::findStructural(const char *p, size_t n) {
+    return active.findStructural(p, n);
+}
+
+JSONScan::Level JSONScan::level() {
+    return active.level;
+}
+
+JSONScan::Level JSONScan::supported() {
+    return best;
+}
+
+void JSONScan::setLevel(Level level) {
+    active = kernelsFor(std::min(level, best));
+}
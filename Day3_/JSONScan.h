@@ -0,0 +1,31 @@
+//
+// Created by Ayr on 2025/12/23.
+//
+
+#ifndef DAY3__JSONSCAN_H
+#define DAY3__JSONSCAN_H
+#include <cstddef>
+
+// JSON 读写热路径上的字符查找，一次比较 16（SSE2）或 32（AVX2）字节
+// 启动时按 CPU 支持情况选择实现，不支持的平台退回逐字节的标量版本
+// 都返回第一个命中的下标，没有命中返回 n
+class JSONScan {
+    public:
+    enum class Level { Scalar, SSE2, AVX2 };
+
+    // 写：需要转义的字符（'"'、'\\'、小于 0x20 的控制字符）
+    static size_t findEscape(const char *p, size_t n);
+    // 读字符串：'"' 或 '\\'
+    static size_t findQuote(const char *p, size_t n);
+    // 跳过整个值：'"'、'\\'、'{'、'}'、'['、']'
+    static size_t findStructural(const char *p, size_t n);
+
+    // 当前使用的实现
+    static Level level();
+    // 本机支持的最高级别
+    static Level supported();
+    // 切换实现（超出 supported() 的按 supported() 处理），供测试与基准对比；不要与读写并发调用
+    static void setLevel(Level level);
+};
+
+#endif //DAY3__JSONSCAN_H
@@ -4,15 +4,35 @@
 
 #ifndef DAY3__SERIALIZER_H
 #define DAY3__SERIALIZER_H
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
-#include <sstream>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "JSONScan.h"
+#include "Writer.h"
 
 // 好好切分运行时多态和编译时多态
 // 运行时多态是用于继承可序列化能力
 // 编译时多态纯为了简化代码
 
 // 目的，完成对嵌套的序列化以及POD+String类型的序列化
+// 类型码：1 int，2 double，3 std::string，4 嵌套 Serializable，
+// 5 std::vector<int>，6 std::vector<double>，7 std::vector<std::string>
 struct Pair {
     int type;
     const void *p;
@@ -25,81 +45,1008 @@ class Serializable {
     [[nodiscard]] virtual Pair* StructInfo() const = 0;
 };
 
+// 编译期字段描述：字段名 + 成员指针
+// 类型提供 static constexpr auto StructFields() 返回 Field 的 tuple 后，
+// Serializer 按字段类型在编译期展开，不再经过虚函数、new Pair[] 和类型码 switch
+template<class C, class M>
+struct Field {
+    const char *name;
+    M C::*member;
+};
+
+template<class C, class M>
+constexpr Field<C, M> field(const char *name, M C::*member) {
+    return {name, member};
+}
+
+// static constexpr auto StructFields() { return std::make_tuple(SERIALIZER_FIELD(User, name), ...); }
+#define SERIALIZER_FIELD(Type, member) field(#member, &Type::member)
+
+template<class T>
+concept Reflectable = requires { T::StructFields(); };
+
+// 依次对每个字段调用 f(field, index)
+template<class T, class F>
+constexpr void forEachField(F &&f) {
+    constexpr auto fields = T::StructFields();
+    std::apply([&](const auto &... field) {
+        size_t i = 0;
+        (f(field, i++), ...);
+    }, fields);
+}
+
+template<class>
+inline constexpr bool unsupportedField = false;
+
+// 支持的容器字段
+template<class>
+inline constexpr bool isVector = false;
+template<class E, class A>
+inline constexpr bool isVector<std::vector<E, A>> = true;
+
+template<class>
+inline constexpr bool isArray = false;
+template<class E, size_t N>
+inline constexpr bool isArray<std::array<E, N>> = true;
+
+template<class>
+inline constexpr bool isMap = false;
+template<class K, class V, class C, class A>
+inline constexpr bool isMap<std::map<K, V, C, A>> = true;
+
+template<class>
+inline constexpr bool isOptional = false;
+template<class E>
+inline constexpr bool isOptional<std::optional<E>> = true;
+
+// 二进制格式里可以整段 memcpy 的元素类型：定宽数值，按小端原样排列
+// 结构体即使平凡可复制，内存布局（填充、对齐）也因编译器而异，不走这条路
+template<class E>
+inline constexpr bool bulkCopyable = std::is_arithmetic_v<E> && !std::same_as<E, bool>;
+
 struct JSONFormat {};
 
+// 紧凑二进制格式，不带字段名，按字段顺序排列：
+// 整数为 varint（有符号先 zigzag），浮点为 8 字节小端 IEEE double，字符串为 varint 长度 + 内容，
+// 嵌套对象直接按其字段顺序内联（双方都知道结构，不需要长度前缀，也就能流式写出）
+// 容器：vector / map 为 varint 元素个数 + 各元素，std::array 长度固定不写个数，optional 为 1 字节标记 + 值；
+// 元素为定宽数值（bulkCopyable）的 vector / array 整段存放 sizeof(E) 字节的小端原值，读写各一次 memcpy
+struct BinaryFormat {};
+
+template<class E>
+constexpr size_t minElementSize();
+
+// 一个 M 在二进制格式里至少占多少字节，用来检查读到的元素个数是否可信
+// 0 表示可能不占字节（如 std::array<T, 0>、没有字段的结构体），这时无法按剩余长度判断
+// Serializable 的字段在运行时才知道，按 0 计
+template<class M>
+constexpr size_t minBinarySize() {
+    if constexpr (std::floating_point<M>) {
+        return 8;
+    }
+    else if constexpr (std::same_as<M, std::string> || std::integral<M> || isVector<M> || isMap<M> || isOptional<M>) {
+        // varint 长度 / 数值 / 个数，或 optional 的标记
+        return 1;
+    }
+    else if constexpr (isArray<M>) {
+        return std::tuple_size_v<M> * minElementSize<typename M::value_type>();
+    }
+    else if constexpr (Reflectable<M>) {
+        size_t size = 0;
+        forEachField<M>([&](const auto &field, size_t) {
+            size += minBinarySize<std::remove_cvref_t<decltype(std::declval<const M &>().*field.member)>>();
+        });
+        return size;
+    }
+    else {
+        return 0;
+    }
+}
+
+// vector / array 里每个元素至少占的字节数：定宽数值整段存放，各占 sizeof(E)
+template<class E>
+constexpr size_t minElementSize() {
+    if constexpr (bulkCopyable<E>) return sizeof(E);
+    else return minBinarySize<E>();
+}
+
+// 二进制输入游标，越界或格式错误时抛异常
+class BinaryReader {
+    const char *cur;
+    const char *end;
+
+    public:
+    BinaryReader(const char *data, size_t size) : cur(data), end(data + size) {}
+
+    [[nodiscard]] bool done() const {
+        return cur == end;
+    }
+
+    [[nodiscard]] const char *position() const {
+        return cur;
+    }
+
+    [[nodiscard]] size_t remaining() const {
+        return end - cur;
+    }
+
+    // 读 count 个定宽数值（小端）到 out
+    template<class E>
+    void copy(E *out, size_t count) {
+        if (count > remaining() / sizeof(E)) throw std::out_of_range{"Unexpected end of binary data"};
+        const char *p = take(count * sizeof(E));
+        if constexpr (std::endian::native == std::endian::little) {
+            if (count) std::memcpy(out, p, count * sizeof(E));
+        }
+        else {
+            for (size_t i = 0; i < count; i++, p += sizeof(E)) {
+                std::array<char, sizeof(E)> bytes;
+                std::reverse_copy(p, p + sizeof(E), bytes.begin());
+                out[i] = std::bit_cast<E>(bytes);
+            }
+        }
+    }
+
+    // 不占字节的元素（minSize 为 0）无法按剩余长度检查，个数另设上限
+    static constexpr uint64_t maxEmptyCount = uint64_t{1} << 20;
+
+    // 读一个元素个数，并按每个元素至少 minSize 字节检查，避免按伪造的个数预先分配或空转
+    size_t count(size_t minSize) {
+        uint64_t n = varint();
+        if (minSize == 0) {
+            if (n > maxEmptyCount) throw std::invalid_argument{"Too many zero-size elements"};
+        }
+        else if (n > remaining() / minSize) {
+            throw std::out_of_range{"Unexpected end of binary data"};
+        }
+        return static_cast<size_t>(n);
+    }
+
+    const char *take(size_t n) {
+        if (static_cast<size_t>(end - cur) < n) throw std::out_of_range{"Unexpected end of binary data"};
+        const char *p = cur;
+        cur += n;
+        return p;
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (cur == end) throw std::out_of_range{"Unexpected end of binary data"};
+            auto byte = static_cast<uint8_t>(*cur++);
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        throw std::invalid_argument{"Varint is too long"};
+    }
+
+    // 有符号整数先还原 zigzag；放不进 M 时抛 std::out_of_range
+    template<class M>
+    M integer() {
+        uint64_t raw = varint();
+        if constexpr (std::is_signed_v<M>) {
+            auto v = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+            if (v < std::numeric_limits<M>::min() || v > std::numeric_limits<M>::max()) {
+                throw std::out_of_range{"Integer out of range"};
+            }
+            return static_cast<M>(v);
+        }
+        else {
+            if (raw > std::numeric_limits<M>::max()) throw std::out_of_range{"Integer out of range"};
+            return static_cast<M>(raw);
+        }
+    }
+
+    double float64() {
+        const char *p = take(8);
+        uint64_t bits = 0;
+        for (int i = 0; i < 8; i++) bits |= static_cast<uint64_t>(static_cast<uint8_t>(p[i])) << (i * 8);
+        return std::bit_cast<double>(bits);
+    }
+
+    // 长度前缀字符串，返回指向输入的视图
+    std::string_view string() {
+        uint64_t size = varint();
+        return {take(size), static_cast<size_t>(size)};
+    }
+};
+
+// JSON 输入游标：单趟扫描 string_view，不分配内存（只有把字符串写进字段时才会）
+// 格式错误抛 std::invalid_argument，数字超出字段类型范围抛 std::out_of_range
+class JSONReader {
+    const char *begin;
+    const char *cur;
+    const char *end;
+
+    [[noreturn]] void fail(const char *what) const {
+        throw std::invalid_argument{std::string{what} + " at offset " + std::to_string(cur - begin)};
+    }
+
+    static void appendUtf8(std::string &out, uint32_t code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        }
+        else if (code < 0x800) {
+            out += static_cast<char>(0xc0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+        }
+        else if (code < 0x10000) {
+            out += static_cast<char>(0xe0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+        }
+        else {
+            out += static_cast<char>(0xf0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+        }
+    }
+
+    uint32_t hex4() {
+        if (end - cur < 4) fail("Truncated \\u escape");
+        uint32_t code = 0;
+        auto [p, ec] = std::from_chars(cur, cur + 4, code, 16);
+        if (ec != std::errc{} || p != cur + 4) fail("Invalid \\u escape");
+        cur += 4;
+        return code;
+    }
+
+    public:
+    explicit JSONReader(std::string_view text) : begin(text.data()), cur(text.data()), end(text.data() + text.size()) {}
+
+    void skipSpace() {
+        while (cur != end && (*cur == ' ' || *cur == '\n' || *cur == '\r' || *cur == '\t')) ++cur;
+    }
+
+    [[nodiscard]] bool done() {
+        skipSpace();
+        return cur == end;
+    }
+
+    // 跳过空白后的下一个字符，到结尾返回 0
+    char peek() {
+        skipSpace();
+        return cur != end ? *cur : '\0';
+    }
+
+    bool consume(char c) {
+        if (peek() != c) return false;
+        ++cur;
+        return true;
+    }
+
+    void expect(char c) {
+        if (consume(c)) return;
+        char what[] = "Expected ' '";
+        what[10] = c;
+        fail(what);
+    }
+
+    // null 字面量，有则读出并返回 true
+    bool null() {
+        if (peek() != 'n') return false;
+        if (end - cur < 4 || std::string_view(cur, 4) != "null") fail("Invalid literal");
+        cur += 4;
+        return true;
+    }
+
+    // 从 cur（开引号之后）跳到闭引号之后；返回中间有没有转义
+    bool skipStringBody() {
+        bool escaped = false;
+        while (true) {
+            cur += JSONScan::findQuote(cur, end - cur);
+            if (cur == end) fail("Unterminated string");
+            if (*cur++ == '"') return escaped;
+            // 反斜杠：连同被转义的字符一起跳过
+            escaped = true;
+            if (cur++ == end) fail("Unterminated string");
+        }
+    }
+
+    // 读一个字符串，返回引号之间未解码的原文；escaped 非空时告知原文里有没有转义
+    std::string_view rawString(bool *escaped = nullptr) {
+        if (peek() != '"') fail("Expected a string");
+        const char *start = ++cur;
+        bool hasEscape = skipStringBody();
+        if (escaped) *escaped = hasEscape;
+        return {start, static_cast<size_t>(cur - 1 - start)};
+    }
+
+    // 成员前可选的 "key":，有则读出并返回 true；没有（或是个字符串值）则不移动
+    bool key(std::string_view &name) {
+        if (peek() != '"') return false;
+        const char *saved = cur;
+        name = rawString();
+        if (consume(':')) return true;
+        cur = saved;
+        return false;
+    }
+
+    void string(std::string &out) {
+        bool escaped;
+        std::string_view raw = rawString(&escaped);
+        if (!escaped) {
+            out.assign(raw);
+            return;
+        }
+        out.clear();
+        const char *saved = cur;
+        cur = raw.data();
+        const char *stop = raw.data() + raw.size();
+        while (true) {
+            // 原文里已没有未转义的引号，命中的只会是反斜杠；之前的片段整段拷贝
+            size_t k = JSONScan::findQuote(cur, stop - cur);
+            out.append(cur, k);
+            cur += k;
+            if (cur == stop) break;
+            ++cur;
+            switch (*cur++) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    uint32_t code = hex4();
+                    // 代理对
+                    if (code >= 0xd800 && code < 0xdc00 && stop - cur >= 6 && cur[0] == '\\' && cur[1] == 'u') {
+                        cur += 2;
+                        uint32_t low = hex4();
+                        if (low < 0xdc00 || low >= 0xe000) fail("Invalid surrogate pair");
+                        code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                    }
+                    appendUtf8(out, code);
+                    break;
+                }
+                default:
+                    --cur;
+                    fail("Invalid escape");
+            }
+        }
+        cur = saved;
+    }
+
+    template<class M>
+    void number(M &out) {
+        skipSpace();
+        // from_chars 还接受 nan、inf 和 .5 这类 JSON 不允许的写法，先确认是数字开头
+        const char *digit = cur != end && *cur == '-' ? cur + 1 : cur;
+        if (digit == end || *digit < '0' || *digit > '9') fail("Expected a number");
+        auto [p, ec] = std::from_chars(cur, end, out);
+        if (ec == std::errc::result_out_of_range) throw std::out_of_range{"Number out of range"};
+        if (ec != std::errc{} || p == cur) fail("Expected a number");
+        cur = p;
+    }
+
+    // 跳过一个任意的值（未知字段）
+    void skipValue() {
+        switch (peek()) {
+            case '"':
+                rawString();
+                break;
+            case '{':
+            case '[': {
+                // 只数括号深度，跳到配对的右括号之后；不检查里面的内容是否合法
+                ++cur;
+                size_t depth = 1;
+                while (depth > 0) {
+                    cur += JSONScan::findStructural(cur, end - cur);
+                    if (cur == end) fail("Unterminated object or array");
+                    switch (*cur++) {
+                        case '"': skipStringBody(); break;
+                        case '{': case '[': depth++; break;
+                        case '}': case ']': depth--; break;
+                        default: fail("Unexpected '\\'");
+                    }
+                }
+                break;
+            }
+            default: {
+                // 数字与 true / false / null
+                const char *start = cur;
+                while (cur != end && *cur != ',' && *cur != '}' && *cur != ']' &&
+                       *cur != ' ' && *cur != '\n' && *cur != '\r' && *cur != '\t') ++cur;
+                if (cur == start) fail("Expected a value");
+            }
+        }
+    }
+};
+
+template<Reflectable T, class Source>
+class BinaryView;
+
 template<class Format>
 class Serializer {
-    public:
-    [[nodiscard]] std::string serialize(const Serializable& obj) const {
-        if constexpr (std::is_same_v<Format, JSONFormat>) {
-            int num = obj.StructNum();
-            Pair* info = obj.StructInfo();
-
-            std::string str = "{";
-            for (int i = 0; i < num; i++) {
-                switch (info[i].type) {
-                    case 1:
-                        // int
-                        str += std::to_string(*static_cast<const int *>(info[i].p));
-                        break;
-                    case 2:
-                        // double
-                        str += std::to_string(*static_cast<const double *>(info[i].p));
-                        break;
-                    case 3:
-                        // std::string
-                        str += "\"" + *static_cast<const std::string *>(info[i].p) + "\"";
-                        break;
-                    case 4:
-                        // 内嵌
-                        str += Serializer<JSONFormat>().serialize(*static_cast<const Serializable *>(info[i].p));
-                        break;
-                    default:
-                        break;
+    // BinaryView 解码容器字段时复用 readBinary
+    template<Reflectable, class>
+    friend class BinaryView;
+
+    // 数字用 to_chars 写进栈上缓冲区，不产生临时字符串
+    // JSON 没有 NaN / Infinity，遇到时抛 std::invalid_argument（已写出的部分留在 out 里）
+    template<class M>
+    static void putNumber(Writer &out, M value) {
+        if constexpr (std::floating_point<M>) {
+            if (!std::isfinite(value)) throw std::invalid_argument{"JSON cannot represent NaN or infinity"};
+        }
+        char digits[32];
+        auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+        out.write(digits, end - digits);
+    }
+
+    // 不需要转义的片段整段写出，只在命中的字符上逐个处理
+    static void putEscaped(Writer &out, std::string_view str) {
+        static constexpr char hex[] = "0123456789abcdef";
+        const char *p = str.data();
+        size_t n = str.size();
+        while (true) {
+            size_t k = JSONScan::findEscape(p, n);
+            out.write(p, k);
+            if (k == n) return;
+            auto c = static_cast<unsigned char>(p[k]);
+            switch (c) {
+                case '"': out.write("\\\"", 2); break;
+                case '\\': out.write("\\\\", 2); break;
+                case '\b': out.write("\\b", 2); break;
+                case '\f': out.write("\\f", 2); break;
+                case '\n': out.write("\\n", 2); break;
+                case '\r': out.write("\\r", 2); break;
+                case '\t': out.write("\\t", 2); break;
+                default: {
+                    char escaped[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf]};
+                    out.write(escaped, 6);
                 }
-                if (i != num - 1) str += ", ";
             }
-            str += "}";
+            p += k + 1;
+            n -= k + 1;
+        }
+    }
 
-            delete[] info;
-            return str;
+    // 按字段类型在编译期选择写法
+    template<class M>
+    static void writeJSON(Writer &out, const M &value) {
+        if constexpr (std::same_as<M, std::string>) {
+            out.put('"');
+            putEscaped(out, value);
+            out.put('"');
+        }
+        else if constexpr (std::floating_point<M>) {
+            putNumber(out, value);
+        }
+        else if constexpr (std::integral<M> && !std::same_as<M, bool>) {
+            putNumber(out, value);
+        }
+        else if constexpr (isVector<M> || isArray<M>) {
+            out.put('[');
+            for (size_t i = 0; i < value.size(); i++) {
+                if (i) out.write(", ", 2);
+                writeJSON(out, value[i]);
+            }
+            out.put(']');
+        }
+        else if constexpr (isMap<M>) {
+            // 键必须是字符串；整数键写成字符串形式
+            using K = typename M::key_type;
+            static_assert(std::same_as<K, std::string> || (std::integral<K> && !std::same_as<K, bool>),
+                          "Map keys must be strings or integers");
+            out.put('{');
+            bool first = true;
+            for (const auto &[k, v] : value) {
+                if (!first) out.write(", ", 2);
+                first = false;
+                out.put('"');
+                if constexpr (std::same_as<K, std::string>) putEscaped(out, k);
+                else putNumber(out, k);
+                out.write("\": ", 3);
+                writeJSON(out, v);
+            }
+            out.put('}');
+        }
+        else if constexpr (isOptional<M>) {
+            if (value) writeJSON(out, *value);
+            else out.write("null", 4);
+        }
+        else if constexpr (Reflectable<M>) {
+            writeObjectJSON(out, value);
+        }
+        else if constexpr (std::derived_from<M, Serializable>) {
+            // 没有编译期描述的嵌套对象退回虚函数路径
+            writeSerializableJSON(out, value);
+        }
+        else {
+            static_assert(unsupportedField<M>, "Unsupported field type");
+        }
+    }
+
+    // 每个成员带 "字段名": 前缀，输出是合法的 JSON 对象；字段名是 C++ 标识符，不需要转义
+    template<class T>
+    static void writeObjectJSON(Writer &out, const T &obj) {
+        constexpr size_t num = std::tuple_size_v<decltype(T::StructFields())>;
+        out.put('{');
+        forEachField<T>([&](const auto &field, size_t i) {
+            std::string_view name{field.name};
+            out.put('"');
+            out.write(name.data(), name.size());
+            out.write("\": ", 3);
+            writeJSON(out, obj.*field.member);
+            if (i != num - 1) out.write(", ", 2);
+        });
+        out.put('}');
+    }
+
+    static void writeSerializableJSON(Writer &out, const Serializable &obj) {
+        int num = obj.StructNum();
+        std::unique_ptr<Pair[]> info{obj.StructInfo()};
+
+        out.put('{');
+        for (int i = 0; i < num; i++) {
+            switch (info[i].type) {
+                case 1:
+                    // int
+                    writeJSON(out, *static_cast<const int *>(info[i].p));
+                    break;
+                case 2:
+                    // double
+                    writeJSON(out, *static_cast<const double *>(info[i].p));
+                    break;
+                case 3:
+                    // std::string
+                    writeJSON(out, *static_cast<const std::string *>(info[i].p));
+                    break;
+                case 4:
+                    // 内嵌，写进同一个输出
+                    writeSerializableJSON(out, *static_cast<const Serializable *>(info[i].p));
+                    break;
+                case 5:
+                    writeJSON(out, *static_cast<const std::vector<int> *>(info[i].p));
+                    break;
+                case 6:
+                    writeJSON(out, *static_cast<const std::vector<double> *>(info[i].p));
+                    break;
+                case 7:
+                    writeJSON(out, *static_cast<const std::vector<std::string> *>(info[i].p));
+                    break;
+                default:
+                    break;
+            }
+            if (i != num - 1) out.write(", ", 2);
+        }
+        out.put('}');
+    }
+
+    template<class M>
+    static void readJSON(JSONReader &in, M &value) {
+        if constexpr (std::same_as<M, std::string>) {
+            in.string(value);
+        }
+        else if constexpr (std::floating_point<M> || (std::integral<M> && !std::same_as<M, bool>)) {
+            in.number(value);
+        }
+        else if constexpr (isVector<M>) {
+            value.clear();
+            in.expect('[');
+            if (in.consume(']')) return;
+            do {
+                readJSON(in, value.emplace_back());
+            } while (in.consume(','));
+            in.expect(']');
+        }
+        else if constexpr (isArray<M>) {
+            in.expect('[');
+            for (size_t i = 0; i < value.size(); i++) {
+                if (i) in.expect(',');
+                readJSON(in, value[i]);
+            }
+            in.expect(']');
+        }
+        else if constexpr (isMap<M>) {
+            using K = typename M::key_type;
+            value.clear();
+            in.expect('{');
+            if (in.consume('}')) return;
+            do {
+                K k{};
+                if constexpr (std::same_as<K, std::string>) {
+                    in.string(k);
+                }
+                else {
+                    std::string_view raw = in.rawString();
+                    auto [p, ec] = std::from_chars(raw.data(), raw.data() + raw.size(), k);
+                    if (ec == std::errc::result_out_of_range) throw std::out_of_range{"Number out of range"};
+                    if (ec != std::errc{} || p != raw.data() + raw.size()) throw std::invalid_argument{"Invalid map key"};
+                }
+                in.expect(':');
+                readJSON(in, value[std::move(k)]);
+            } while (in.consume(','));
+            in.expect('}');
+        }
+        else if constexpr (isOptional<M>) {
+            if (in.null()) value.reset();
+            else readJSON(in, value.emplace());
+        }
+        else if constexpr (Reflectable<M>) {
+            readObjectJSON(in, value);
+        }
+        else if constexpr (std::derived_from<M, Serializable>) {
+            readSerializableJSON(in, value);
+        }
+        else {
+            static_assert(unsupportedField<M>, "Unsupported field type");
+        }
+    }
+
+    // 成员可以带 "key": 前缀，带 key 时按字段名匹配（顺序随意，未知字段跳过），否则按位置
+    template<class T>
+    static void readObjectJSON(JSONReader &in, T &obj) {
+        in.expect('{');
+        if (in.consume('}')) return;
+        size_t index = 0;
+        do {
+            std::string_view name;
+            bool keyed = in.key(name);
+            bool found = false;
+            forEachField<T>([&](const auto &field, size_t i) {
+                if (!found && (keyed ? name == field.name : i == index)) {
+                    readJSON(in, obj.*field.member);
+                    found = true;
+                }
+            });
+            if (!found) {
+                if (!keyed) throw std::invalid_argument{"Too many tokens"};
+                in.skipValue();
+            }
+            index++;
+        } while (in.consume(','));
+        in.expect('}');
+    }
+
+    // 没有字段名可用，只能按位置；带 key 的输入忽略 key
+    // 嵌套成员就是 obj 里已经存在的对象，直接用它自己的 StructInfo 填充
+    static void readSerializableJSON(JSONReader &in, Serializable &obj) {
+        int num = obj.StructNum();
+        std::unique_ptr<Pair[]> info{obj.StructInfo()};
+
+        in.expect('{');
+        if (in.consume('}')) return;
+        int i = 0;
+        do {
+            if (i >= num) throw std::invalid_argument{"Too many tokens"};
+            std::string_view name;
+            in.key(name);
+            void *p = const_cast<void *>(info[i].p);
+            switch (info[i].type) {
+                case 1:
+                    // int
+                    readJSON(in, *static_cast<int *>(p));
+                    break;
+                case 2:
+                    // double
+                    readJSON(in, *static_cast<double *>(p));
+                    break;
+                case 3:
+                    // std::string
+                    readJSON(in, *static_cast<std::string *>(p));
+                    break;
+                case 4:
+                    // 内嵌
+                    readSerializableJSON(in, *static_cast<Serializable *>(p));
+                    break;
+                case 5:
+                    readJSON(in, *static_cast<std::vector<int> *>(p));
+                    break;
+                case 6:
+                    readJSON(in, *static_cast<std::vector<double> *>(p));
+                    break;
+                case 7:
+                    readJSON(in, *static_cast<std::vector<std::string> *>(p));
+                    break;
+                default:
+                    in.skipValue();
+                    break;
+            }
+            i++;
+        } while (in.consume(','));
+        in.expect('}');
+    }
+
+    static void putVarint(Writer &out, uint64_t value) {
+        char bytes[10];
+        size_t n = 0;
+        while (value >= 0x80) {
+            bytes[n++] = static_cast<char>(value | 0x80);
+            value >>= 7;
+        }
+        bytes[n++] = static_cast<char>(value);
+        out.write(bytes, n);
+    }
+
+    static void putFloat64(Writer &out, double value) {
+        auto bits = std::bit_cast<uint64_t>(value);
+        char bytes[8];
+        for (int i = 0; i < 8; i++) bytes[i] = static_cast<char>(bits >> (i * 8));
+        out.write(bytes, 8);
+    }
+
+    // 定宽数值整段写出；小端机器上就是一次拷贝
+    template<class E>
+    static void putBulk(Writer &out, const E *data, size_t count) {
+        if constexpr (std::endian::native == std::endian::little) {
+            // 空 vector 的 data() 可能为空指针，不能交给 memcpy
+            if (count) out.write(reinterpret_cast<const char *>(data), count * sizeof(E));
+        }
+        else {
+            for (size_t i = 0; i < count; i++) {
+                auto bytes = std::bit_cast<std::array<char, sizeof(E)>>(data[i]);
+                std::reverse(bytes.begin(), bytes.end());
+                out.write(bytes.data(), sizeof(E));
+            }
+        }
+    }
+
+    // zigzag：让绝对值小的负数也编码得短
+    static uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    template<class M>
+    static void writeBinary(Writer &out, const M &value) {
+        if constexpr (std::same_as<M, std::string>) {
+            putVarint(out, value.size());
+            out.write(value);
+        }
+        else if constexpr (std::floating_point<M>) {
+            putFloat64(out, static_cast<double>(value));
+        }
+        else if constexpr (std::integral<M> && !std::same_as<M, bool>) {
+            if constexpr (std::is_signed_v<M>) putVarint(out, zigzag(value));
+            else putVarint(out, value);
+        }
+        else if constexpr (isVector<M> || isArray<M>) {
+            using E = typename M::value_type;
+            if constexpr (isVector<M>) putVarint(out, value.size());
+            if constexpr (bulkCopyable<E>) {
+                putBulk(out, value.data(), value.size());
+            }
+            else {
+                for (const E &e : value) writeBinary(out, e);
+            }
+        }
+        else if constexpr (isMap<M>) {
+            putVarint(out, value.size());
+            for (const auto &[k, v] : value) {
+                writeBinary(out, k);
+                writeBinary(out, v);
+            }
+        }
+        else if constexpr (isOptional<M>) {
+            out.put(value ? 1 : 0);
+            if (value) writeBinary(out, *value);
+        }
+        else if constexpr (Reflectable<M>) {
+            writeObjectBinary(out, value);
+        }
+        else if constexpr (std::derived_from<M, Serializable>) {
+            writeSerializableBinary(out, value);
+        }
+        else {
+            static_assert(unsupportedField<M>, "Unsupported field type");
+        }
+    }
+
+    template<class T>
+    static void writeObjectBinary(Writer &out, const T &obj) {
+        forEachField<T>([&](const auto &field, size_t) {
+            writeBinary(out, obj.*field.member);
+        });
+    }
+
+    static void writeSerializableBinary(Writer &out, const Serializable &obj) {
+        int num = obj.StructNum();
+        std::unique_ptr<Pair[]> info{obj.StructInfo()};
+        for (int i = 0; i < num; i++) {
+            switch (info[i].type) {
+                case 1:
+                    writeBinary(out, *static_cast<const int *>(info[i].p));
+                    break;
+                case 2:
+                    writeBinary(out, *static_cast<const double *>(info[i].p));
+                    break;
+                case 3:
+                    writeBinary(out, *static_cast<const std::string *>(info[i].p));
+                    break;
+                case 4:
+                    writeSerializableBinary(out, *static_cast<const Serializable *>(info[i].p));
+                    break;
+                case 5:
+                    writeBinary(out, *static_cast<const std::vector<int> *>(info[i].p));
+                    break;
+                case 6:
+                    writeBinary(out, *static_cast<const std::vector<double> *>(info[i].p));
+                    break;
+                case 7:
+                    writeBinary(out, *static_cast<const std::vector<std::string> *>(info[i].p));
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    template<class M>
+    static void readBinary(BinaryReader &reader, M &value) {
+        if constexpr (std::same_as<M, std::string>) {
+            value.assign(reader.string());
+        }
+        else if constexpr (std::floating_point<M>) {
+            value = static_cast<M>(reader.float64());
+        }
+        else if constexpr (std::integral<M> && !std::same_as<M, bool>) {
+            value = reader.integer<M>();
+        }
+        else if constexpr (isVector<M>) {
+            using E = typename M::value_type;
+            size_t count = reader.count(minElementSize<E>());
+            if constexpr (bulkCopyable<E>) {
+                value.resize(count);
+                reader.copy(value.data(), count);
+            }
+            else {
+                value.clear();
+                value.reserve(count);
+                for (size_t i = 0; i < count; i++) readBinary(reader, value.emplace_back());
+            }
+        }
+        else if constexpr (isArray<M>) {
+            if constexpr (bulkCopyable<typename M::value_type>) reader.copy(value.data(), value.size());
+            else for (auto &e : value) readBinary(reader, e);
+        }
+        else if constexpr (isMap<M>) {
+            size_t count = reader.count(minBinarySize<typename M::key_type>() + minBinarySize<typename M::mapped_type>());
+            value.clear();
+            for (size_t i = 0; i < count; i++) {
+                typename M::key_type k{};
+                readBinary(reader, k);
+                readBinary(reader, value[std::move(k)]);
+            }
+        }
+        else if constexpr (isOptional<M>) {
+            char flag = *reader.take(1);
+            if (flag == 0) value.reset();
+            else if (flag == 1) readBinary(reader, value.emplace());
+            else throw std::invalid_argument{"Invalid optional flag"};
+        }
+        else if constexpr (Reflectable<M>) {
+            readObjectBinary(reader, value);
+        }
+        else if constexpr (std::derived_from<M, Serializable>) {
+            readSerializableBinary(reader, value);
+        }
+        else {
+            static_assert(unsupportedField<M>, "Unsupported field type");
+        }
+    }
+
+    template<class T>
+    static void readObjectBinary(BinaryReader &reader, T &obj) {
+        forEachField<T>([&](const auto &field, size_t) {
+            readBinary(reader, obj.*field.member);
+        });
+    }
+
+    // 嵌套成员就是 obj 里已经存在的对象，直接用它自己的 StructInfo 填充
+    static void readSerializableBinary(BinaryReader &reader, Serializable &obj) {
+        int num = obj.StructNum();
+        std::unique_ptr<Pair[]> info{obj.StructInfo()};
+        for (int i = 0; i < num; i++) {
+            void *p = const_cast<void *>(info[i].p);
+            switch (info[i].type) {
+                case 1:
+                    readBinary(reader, *static_cast<int *>(p));
+                    break;
+                case 2:
+                    readBinary(reader, *static_cast<double *>(p));
+                    break;
+                case 3:
+                    readBinary(reader, *static_cast<std::string *>(p));
+                    break;
+                case 4:
+                    readSerializableBinary(reader, *static_cast<Serializable *>(p));
+                    break;
+                case 5:
+                    readBinary(reader, *static_cast<std::vector<int> *>(p));
+                    break;
+                case 6:
+                    readBinary(reader, *static_cast<std::vector<double> *>(p));
+                    break;
+                case 7:
+                    readBinary(reader, *static_cast<std::vector<std::string> *>(p));
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    public:
+    // 流式写入 out，嵌套对象写进同一个输出，不产生中间字符串
+    // 有编译期字段描述的类型走这里（比 const Serializable& 更匹配）
+    template<Reflectable T>
+    void serialize(const T& obj, Writer& out) const {
+        if constexpr (std::is_same_v<Format, JSONFormat>) {
+            writeObjectJSON(out, obj);
+        }
+        else if constexpr (std::is_same_v<Format, BinaryFormat>) {
+            writeObjectBinary(out, obj);
         }
         else {
             throw std::logic_error{"Unknown format"};
         }
     }
+
+    void serialize(const Serializable& obj, Writer& out) const {
+        if constexpr (std::is_same_v<Format, JSONFormat>) {
+            writeSerializableJSON(out, obj);
+        }
+        else if constexpr (std::is_same_v<Format, BinaryFormat>) {
+            writeSerializableBinary(out, obj);
+        }
+        else {
+            throw std::logic_error{"Unknown format"};
+        }
+    }
+
+    // 便捷接口：返回字符串，每次调用都要分配；热路径上复用 Writer
+    template<Reflectable T>
+    [[nodiscard]] std::string serialize(const T& obj) const {
+        StringWriter out;
+        serialize(obj, out);
+        return out.take();
+    }
+
+    [[nodiscard]] std::string serialize(const Serializable& obj) const {
+        StringWriter out;
+        serialize(obj, out);
+        return out.take();
+    }
+
     template<class T>
-    [[nodiscard]] T deserialize(const std::string& str) {
+    [[nodiscard]] T deserialize(std::string_view str) {
         if constexpr (std::is_same_v<Format, JSONFormat>) {
             T obj;
-            int num = obj.StructNum();
-            Pair* info = obj.StructInfo(); // 用RAII不然抛异常会泄露
-
-            std::string token;
-            std::stringstream ss{str.substr(1, str.length() - 2)};
-            for (int i = 0; std::getline(ss, token, ','); i++) {
-                if (i >= num) throw std::logic_error{"Too many tokens"};
-                switch (info[i].type) {
-                    case 1:
-                        // int
-                        *static_cast<int *>(const_cast<void *>(info[i].p)) = std::stoi(token);
-                        break;
-                    case 2:
-                        // double
-                        *static_cast<double *>(const_cast<void *>(info[i].p)) = std::stod(token);
-                        break;
-                    case 3:
-                        // std::string
-                        *static_cast<std::string *>(const_cast<void *>(info[i].p)) = token.substr(1, token.length() - 2);
-                        break;
-                    case 4:
-                        // 嵌套怎么处理？无法判断嵌套类型具体是哪个。总不能跑过去用模板吧
-                        // *static_cast<T *>(const_cast<void *>(info[i].p)) = Serializer<JSONFormat>().deserialize<T>(token);
-                        break;
-                    default:
-                        break;
-                }
-            }
+            JSONReader reader{str};
+            readSerializableJSON(reader, obj);
+            if (!reader.done()) throw std::invalid_argument{"Trailing characters after object"};
+            return obj;
+        }
+        else if constexpr (std::is_same_v<Format, BinaryFormat>) {
+            T obj;
+            BinaryReader reader{str.data(), str.size()};
+            readSerializableBinary(reader, obj);
+            if (!reader.done()) throw std::invalid_argument{"Trailing bytes after object"};
+            return obj;
+        }
+        else {
+            throw std::logic_error{"Unknown format"};
+        }
+    }
+
+    template<Reflectable T>
+    [[nodiscard]] T deserialize(std::string_view str) {
+        if constexpr (std::is_same_v<Format, JSONFormat>) {
+            T obj;
+            JSONReader reader{str};
+            readObjectJSON(reader, obj);
+            if (!reader.done()) throw std::invalid_argument{"Trailing characters after object"};
+            return obj;
+        }
+        else if constexpr (std::is_same_v<Format, BinaryFormat>) {
+            T obj;
+            BinaryReader reader{str.data(), str.size()};
+            readObjectBinary(reader, obj);
+            if (!reader.done()) throw std::invalid_argument{"Trailing bytes after object"};
             return obj;
         }
         else {
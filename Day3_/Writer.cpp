@@ -0,0 +1,85 @@
+//
+// Created by Ayr on 2025/12/23.
+//
+
+#include "Writer.h"
+#include <algorithm>
+#include <cerrno>
+#include <system_error>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+StringWriter::StringWriter(size_t capacity) {
+    // 至少用上字符串内联的那部分空间，短输出不用分配
+    buffer.resize(std::max(capacity, buffer.capacity()));
+    setWindow(buffer.data(), buffer.data(), buffer.data() + buffer.size());
+}
+
+void StringWriter::overflow(const char *data, size_t n) {
+    size_t used = size();
+    buffer.resize(std::max({buffer.size() * 2, used + n, size_t{64}}));
+    setWindow(buffer.data(), buffer.data() + used, buffer.data() + buffer.size());
+    std::memcpy(cur, data, n);
+    cur += n;
+}
+
+std::string StringWriter::take() {
+    buffer.resize(size());
+    std::string result = std::move(buffer);
+    buffer.clear();
+    setWindow(buffer.data(), buffer.data(), buffer.data());
+    return result;
+}
+
+// ----
+
+FdWriter::FdWriter(int fd, size_t capacity)
+    : fd(fd), capacity(std::max<size_t>(capacity, 1)), storage(new char[this->capacity]) {
+    setWindow(storage.get(), storage.get(), storage.get() + this->capacity);
+}
+
+FdWriter::~FdWriter() {
+    try {
+        flush();
+    }
+    catch (...) {
+        // 析构中无法报告错误，需要确认写成功时先显式 flush()
+    }
+}
+
+void FdWriter::writeAll(const char *data, size_t n) {
+    while (n > 0) {
+#ifdef _WIN32
+        int written = ::_write(fd, data, static_cast<unsigned>(std::min<size_t>(n, 1u << 30)));
+#else
+        ssize_t written = ::write(fd, data, n);
+#endif
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw std::system_error{errno, std::generic_category(), "write failed"};
+        }
+        data += written;
+        n -= static_cast<size_t>(written);
+    }
+}
+
+void FdWriter::overflow(const char *data, size_t n) {
+    flush();
+    if (n >= capacity) {
+        writeAll(data, n);
+        return;
+    }
+    std::memcpy(cur, data, n);
+    cur += n;
+}
+
+void FdWriter::flush() {
+    // 先清空缓冲区再写，写失败时不会把同一段数据重复写出
+    size_t n = cur - begin;
+    cur = begin;
+    writeAll(begin, n);
+}
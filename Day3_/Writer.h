@@ -0,0 +1,146 @@
+//
+// Created by Ayr on 2025/12/23.
+//
+
+#ifndef DAY3__WRITER_H
+#define DAY3__WRITER_H
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// 序列化输出端：在 [cur, end) 窗口里直接追加，只有空间不够时才调用一次虚函数 overflow
+// 窗口由子类提供：可增长的字符串、池内 Buffer、带缓冲的文件描述符
+// 子类复用自己的存储，稳态下每条记录不再分配内存
+class Writer {
+    protected:
+    char *begin = nullptr;
+    char *cur = nullptr;
+    char *end = nullptr;
+
+    void setWindow(char *begin, char *cur, char *end) {
+        this->begin = begin;
+        this->cur = cur;
+        this->end = end;
+    }
+
+    // 剩余空间放不下 data[0, n)：由子类腾出空间并写入全部 n 字节，做不到就抛异常
+    virtual void overflow(const char *data, size_t n) = 0;
+
+    public:
+    virtual ~Writer() = default;
+
+    Writer() = default;
+    Writer(const Writer &) = delete;
+    Writer &operator=(const Writer &) = delete;
+
+    void write(const char *data, size_t n) {
+        if (static_cast<size_t>(end - cur) >= n) {
+            std::memcpy(cur, data, n);
+            cur += n;
+        }
+        else {
+            overflow(data, n);
+        }
+    }
+
+    void write(std::string_view str) {
+        write(str.data(), str.size());
+    }
+
+    void put(char c) {
+        if (cur != end) *cur++ = c;
+        else overflow(&c, 1);
+    }
+
+    // 把缓冲的数据交给下游；只在内存里累积的 Writer 什么也不做
+    virtual void flush() {}
+};
+
+// 写进自己持有的 std::string，空间不够时倍增
+// clear() 保留容量，同一个 StringWriter 反复使用时不再分配
+class StringWriter : public Writer {
+    std::string buffer;
+
+    protected:
+    void overflow(const char *data, size_t n) override;
+
+    public:
+    explicit StringWriter(size_t capacity = 0);
+
+    [[nodiscard]] size_t size() const {
+        return cur - begin;
+    }
+
+    [[nodiscard]] std::string_view view() const {
+        return {begin, size()};
+    }
+
+    void clear() {
+        cur = begin;
+    }
+
+    // 取走内容，之后 StringWriter 为空（容量也随字符串交出）
+    std::string take();
+};
+
+// 写进调用方提供的定长缓冲区（如 Day1 BufferPool 的 Buffer），写满抛 std::length_error
+// Buffer 只需可移动并提供 data()；持有期间缓冲区不会回到池中
+template<class Buffer>
+class BufferWriter : public Writer {
+    Buffer buffer;
+
+    protected:
+    void overflow(const char *, size_t) override {
+        throw std::length_error{"Buffer is full"};
+    }
+
+    public:
+    BufferWriter(Buffer buffer, size_t capacity) : buffer(std::move(buffer)) {
+        char *data = this->buffer.data();
+        setWindow(data, data, data + capacity);
+    }
+
+    [[nodiscard]] size_t size() const {
+        return cur - begin;
+    }
+
+    [[nodiscard]] std::string_view view() const {
+        return {begin, size()};
+    }
+
+    void clear() {
+        cur = begin;
+    }
+
+    // 交还缓冲区，已写入 size() 字节
+    Buffer release() {
+        setWindow(nullptr, nullptr, nullptr);
+        return std::move(buffer);
+    }
+};
+
+// 带缓冲地写文件描述符，缓冲区满或 flush() 时调用 write
+// 单次写入超过缓冲区容量时直接写出，不经过缓冲区；写失败抛 std::system_error
+// 析构时尽力 flush，不关闭 fd
+class FdWriter : public Writer {
+    int fd;
+    size_t capacity;
+    std::unique_ptr<char[]> storage;
+
+    void writeAll(const char *data, size_t n);
+
+    protected:
+    void overflow(const char *data, size_t n) override;
+
+    public:
+    explicit FdWriter(int fd, size_t capacity = 64 * 1024);
+    ~FdWriter() override;
+
+    void flush() override;
+};
+
+#endif //DAY3__WRITER_H
@@ -1,5 +1,39 @@
 #include <iostream>
+#include <cassert>
+#include <chrono>
+#include <algorithm>
+#include <optional>
+#include <map>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <cstdio>
+#include <new>
+#include <vector>
 #include "Serializer.h"
+#include "BinaryView.h"
+
+// 统计堆分配次数，验证流式写入稳态下不分配
+// GCC 内联后会把这里的 malloc / free 误判为与 new / delete 不配对
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    ++allocations;
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
 
 class User : public Serializable {
 public:
@@ -16,6 +50,788 @@ public:
         return new Pair[2]{{3, &name}, {1, &age}};
     };
 };
+
+// 只有 Serializable，嵌套一个 Serializable
+class Team : public Serializable {
+public:
+    std::string name;
+    User leader;
+
+    [[nodiscard]] int StructNum() const final {
+        return 2;
+    }
+    [[nodiscard]] Pair* StructInfo() const final {
+        return new Pair[2]{{3, &name}, {4, static_cast<const Serializable *>(&leader)}};
+    }
+};
+
+// 同时提供两种描述：serialize(obj) 走编译期路径，转成 const Serializable& 走虚函数路径
+class Address : public Serializable {
+public:
+    std::string city;
+    int zip;
+
+    Address(std::string city = "", int zip = 0) : city(std::move(city)), zip(zip) {}
+
+    [[nodiscard]] int StructNum() const final {
+        return 2;
+    }
+    [[nodiscard]] Pair* StructInfo() const final {
+        return new Pair[2]{{3, &city}, {1, &zip}};
+    }
+    static constexpr auto StructFields() {
+        return std::make_tuple(SERIALIZER_FIELD(Address, city), SERIALIZER_FIELD(Address, zip));
+    }
+};
+
+class Person : public Serializable {
+public:
+    std::string name;
+    int age;
+    double score;
+    Address address;
+
+    Person(std::string name = "", int age = 0, double score = 0, Address address = {})
+        : name(std::move(name)), age(age), score(score), address(std::move(address)) {}
+
+    [[nodiscard]] int StructNum() const final {
+        return 4;
+    }
+    [[nodiscard]] Pair* StructInfo() const final {
+        return new Pair[4]{{3, &name}, {1, &age}, {2, &score}, {4, static_cast<const Serializable *>(&address)}};
+    }
+    static constexpr auto StructFields() {
+        return std::make_tuple(SERIALIZER_FIELD(Person, name), SERIALIZER_FIELD(Person, age),
+                               SERIALIZER_FIELD(Person, score), SERIALIZER_FIELD(Person, address));
+    }
+};
+
+// 只有编译期描述，不继承 Serializable
+struct Point {
+    int x = 0;
+    int y = 0;
+    std::string label;
+
+    static constexpr auto StructFields() {
+        return std::make_tuple(SERIALIZER_FIELD(Point, x), SERIALIZER_FIELD(Point, y), SERIALIZER_FIELD(Point, label));
+    }
+};
+
+// 容器字段
+struct Series {
+    std::string name;
+    std::vector<double> values;
+    std::vector<int> ids;
+    std::array<int32_t, 3> rgb{};
+    std::map<std::string, int> counts;
+    std::map<int, std::string> labels;
+    std::optional<double> limit;
+    std::optional<Point> origin;
+    std::vector<Point> points;
+    std::vector<std::string> tags;
+
+    static constexpr auto StructFields() {
+        return std::make_tuple(SERIALIZER_FIELD(Series, name), SERIALIZER_FIELD(Series, values),
+                               SERIALIZER_FIELD(Series, ids), SERIALIZER_FIELD(Series, rgb),
+                               SERIALIZER_FIELD(Series, counts), SERIALIZER_FIELD(Series, labels),
+                               SERIALIZER_FIELD(Series, limit), SERIALIZER_FIELD(Series, origin),
+                               SERIALIZER_FIELD(Series, points), SERIALIZER_FIELD(Series, tags));
+    }
+
+    bool operator==(const Series& other) const {
+        auto samePoint = [](const Point& a, const Point& b) { return a.x == b.x && a.y == b.y && a.label == b.label; };
+        return name == other.name && values == other.values && ids == other.ids && rgb == other.rgb &&
+               counts == other.counts && labels == other.labels && limit == other.limit &&
+               origin.has_value() == other.origin.has_value() && (!origin || samePoint(*origin, *other.origin)) &&
+               std::equal(points.begin(), points.end(), other.points.begin(), other.points.end(), samePoint) &&
+               tags == other.tags;
+    }
+};
+
+// 只有 Serializable，容器用类型码 5 / 6 / 7
+class Samples : public Serializable {
+public:
+    std::vector<int> ids;
+    std::vector<double> values;
+    std::vector<std::string> tags;
+
+    [[nodiscard]] int StructNum() const final {
+        return 3;
+    }
+    [[nodiscard]] Pair* StructInfo() const final {
+        return new Pair[3]{{5, &ids}, {6, &values}, {7, &tags}};
+    }
+};
+
+// 包一层的 double：vector<Boxed> 逐元素编码，字节与 vector<double> 相同，用来对比整段拷贝
+struct Boxed {
+    double v;
+
+    static constexpr auto StructFields() {
+        return std::make_tuple(SERIALIZER_FIELD(Boxed, v));
+    }
+};
+
+// 编码后不占字节的元素：没有字段的结构体、std::array<T, 0>
+struct Empty {
+    static constexpr auto StructFields() {
+        return std::make_tuple();
+    }
+};
+
+struct Hollow {
+    std::vector<Empty> empties;
+    std::map<int, Empty> keys;
+    std::vector<std::array<int32_t, 0>> blanks;
+
+    static constexpr auto StructFields() {
+        return std::make_tuple(SERIALIZER_FIELD(Hollow, empties), SERIALIZER_FIELD(Hollow, keys),
+                               SERIALIZER_FIELD(Hollow, blanks));
+    }
+};
+
+template<typename F>
+double timeIt(F&& f) {
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void testReflection() {
+    std::cout << "Running reflection tests...\n";
+    Serializer<JSONFormat> json;
+
+    // 编译期路径带字段名，虚函数路径只能按位置；两种输出解码结果一致
+    Person person{"Bob", 30, 1.5, {"Paris", 75001}};
+    std::string reflected = json.serialize(person);
+    std::string virtualPath = json.serialize(static_cast<const Serializable &>(person));
+    assert(reflected == "{\"name\": \"Bob\", \"age\": 30, \"score\": 1.5, \"address\": {\"city\": \"Paris\", \"zip\": 75001}}");
+    assert(virtualPath == "{\"Bob\", 30, 1.5, {\"Paris\", 75001}}");
+    for (const std::string& text : {reflected, virtualPath}) {
+        Person back = json.deserialize<Person>(text);
+        assert(back.name == "Bob" && back.age == 30 && back.score == 1.5);
+        assert(back.address.city == "Paris" && back.address.zip == 75001);
+    }
+
+    Point point = json.deserialize<Point>("{3, -4, \"origin\"}");
+    assert(point.x == 3 && point.y == -4 && point.label == "origin");
+    assert(json.serialize(point) == "{\"x\": 3, \"y\": -4, \"label\": \"origin\"}");
+
+    // Benchmark: 编译期展开 vs 虚函数 + new Pair[] + switch
+    {
+        constexpr int N = 500000;
+        size_t bytesReflected = 0, bytesVirtual = 0;
+        StringWriter out;
+        double tReflected = timeIt([&] {
+            for (int i = 0; i < N; ++i) {
+                out.clear();
+                json.serialize(person, out);
+                bytesReflected += out.size();
+            }
+        });
+        double tVirtual = timeIt([&] {
+            for (int i = 0; i < N; ++i) {
+                out.clear();
+                json.serialize(static_cast<const Serializable &>(person), out);
+                bytesVirtual += out.size();
+            }
+        });
+        assert(bytesReflected == size_t(N) * reflected.size() && bytesVirtual == size_t(N) * virtualPath.size());
+        std::cout << "  serialize x" << N << ": reflected " << tReflected << " ms, Serializable " << tVirtual << " ms\n";
+    }
+
+    std::cout << "[OK] All reflection tests passed\n";
+}
+
+void testBinary() {
+    std::cout << "Running binary format tests...\n";
+    Serializer<BinaryFormat> binary;
+    Serializer<JSONFormat> json;
+
+    // 字节布局：zigzag varint、长度前缀字符串
+    Point point{3, -4, "origin"};
+    std::string bytes = binary.serialize(point);
+    assert(bytes == std::string("\x06\x07\x06origin", 9));
+    Point back = binary.deserialize<Point>(bytes);
+    assert(back.x == 3 && back.y == -4 && back.label == "origin");
+
+    // 多字节 varint 与极值
+    Point extreme{std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), std::string(300, 'x')};
+    back = binary.deserialize<Point>(binary.serialize(extreme));
+    assert(back.x == extreme.x && back.y == extreme.y && back.label == extreme.label);
+
+    // 嵌套对象，两条路径字节一致且可以互相解码
+    Person person{"Bob", 30, 1.5, {"Paris", 75001}};
+    std::string reflected = binary.serialize(person);
+    assert(reflected == binary.serialize(static_cast<const Serializable &>(person)));
+    Person decoded = binary.deserialize<Person>(reflected);
+    assert(decoded.name == "Bob" && decoded.age == 30 && decoded.score == 1.5);
+    assert(decoded.address.city == "Paris" && decoded.address.zip == 75001);
+
+    // 只有 Serializable 的类型走虚函数路径
+    User user = binary.deserialize<User>(binary.serialize(User("Alice", -14)));
+    assert(user.name == "Alice" && user.age == -14);
+
+    // 截断、多余字节、越界都报错
+    bool threw = false;
+    try { (void)binary.deserialize<Person>(reflected.substr(0, reflected.size() - 1)); }
+    catch (const std::out_of_range &) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { (void)binary.deserialize<Point>(bytes + "x"); }
+    catch (const std::invalid_argument &) { threw = true; }
+    assert(threw);
+
+    // Benchmark: 编解码吞吐与体积
+    {
+        constexpr int N = 500000;
+        std::string jsonText = json.serialize(point);
+        size_t sink = 0;
+        double encodeJSON = timeIt([&] {
+            for (int i = 0; i < N; ++i) sink += json.serialize(point).size();
+        });
+        double encodeBinary = timeIt([&] {
+            for (int i = 0; i < N; ++i) sink += binary.serialize(point).size();
+        });
+        double decodeJSON = timeIt([&] {
+            for (int i = 0; i < N; ++i) sink += json.deserialize<Point>(jsonText).x;
+        });
+        double decodeBinary = timeIt([&] {
+            for (int i = 0; i < N; ++i) sink += binary.deserialize<Point>(bytes).x;
+        });
+        assert(sink > 0);
+        std::cout << "  Point x" << N << " encode: JSON " << encodeJSON << " ms, binary " << encodeBinary << " ms\n"
+                  << "  Point x" << N << " decode: JSON " << decodeJSON << " ms, binary " << decodeBinary << " ms\n"
+                  << "  size: Point JSON " << jsonText.size() << " B, binary " << bytes.size() << " B; "
+                  << "Person JSON " << json.serialize(person).size() << " B, binary " << reflected.size() << " B\n";
+    }
+
+    std::cout << "[OK] All binary format tests passed\n";
+}
+
+// 模拟 Day1 的 Buffer：只能移动，提供 data()
+struct MockBuffer {
+    std::unique_ptr<char[]> bytes;
+
+    char* data() const {
+        return bytes.get();
+    }
+};
+
+void testWriter() {
+    std::cout << "Running writer tests...\n";
+    Serializer<JSONFormat> json;
+    Serializer<BinaryFormat> binary;
+    Person person{"Bob", 30, 1.5, {"Paris", 75001}};
+    const std::string expected = json.serialize(person);
+
+    // 复用 StringWriter：热身之后不再分配
+    {
+        StringWriter out;
+        json.serialize(person, out);
+        assert(out.view() == expected);
+        size_t before = allocations;
+        for (int i = 0; i < 1000; ++i) {
+            out.clear();
+            json.serialize(person, out);
+            binary.serialize(person, out);
+        }
+        assert(allocations == before);
+        assert(out.view().substr(0, expected.size()) == expected);
+        assert(out.take() == expected + binary.serialize(person));
+        assert(out.size() == 0);
+    }
+
+    // 写进池内缓冲区，写满抛异常
+    {
+        BufferWriter<MockBuffer> out{MockBuffer{std::make_unique<char[]>(128)}, 128};
+        json.serialize(person, out);
+        assert(out.view() == expected);
+        bool threw = false;
+        try { json.serialize(person, out); }
+        catch (const std::length_error&) { threw = true; }
+        assert(threw);
+        size_t written = out.size();
+        MockBuffer buffer = out.release();
+        assert(std::string(buffer.data(), expected.size()) == expected && written <= 128);
+    }
+
+    // 写文件描述符：缓冲区很小，既有攒批也有直接写出
+    {
+        std::FILE* file = std::tmpfile();
+        assert(file);
+        {
+            FdWriter out{fileno(file), 16};
+            for (int i = 0; i < 100; ++i) {
+                json.serialize(person, out);
+                out.put('\n');
+            }
+        }
+        std::string contents(100 * (expected.size() + 1), '\0');
+        std::rewind(file);
+        assert(std::fread(contents.data(), 1, contents.size() + 1, file) == contents.size());
+        for (int i = 0; i < 100; ++i) assert(contents.compare(i * (expected.size() + 1), expected.size(), expected) == 0);
+        std::fclose(file);
+    }
+
+    // Benchmark: 每次返回新字符串 vs 复用 Writer
+    {
+        constexpr int N = 500000;
+        size_t bytesString = 0, bytesStream = 0;
+        size_t before = allocations;
+        double tString = timeIt([&] {
+            for (int i = 0; i < N; ++i) bytesString += json.serialize(person).size();
+        });
+        size_t allocString = allocations - before;
+        StringWriter out;
+        before = allocations;
+        double tStream = timeIt([&] {
+            for (int i = 0; i < N; ++i) {
+                out.clear();
+                json.serialize(person, out);
+                bytesStream += out.size();
+            }
+        });
+        size_t allocStream = allocations - before;
+        assert(bytesString == bytesStream);
+        std::cout << "  JSON x" << N << ": string " << tString << " ms (" << double(allocString) / N
+                  << " allocs/record), Writer " << tStream << " ms (" << double(allocStream) / N << " allocs/record)\n";
+    }
+
+    std::cout << "[OK] All writer tests passed\n";
+}
+
+void testJSONParser() {
+    std::cout << "Running JSON parser tests...\n";
+    Serializer<JSONFormat> json;
+
+    // 字符串里的逗号、括号不再切坏记录
+    Point point = json.deserialize<Point>("{1, 2, \"a, b} {c\"}");
+    assert(point.x == 1 && point.y == 2 && point.label == "a, b} {c");
+
+    // 带 key：顺序随意，未知字段跳过；空白随意
+    point = json.deserialize<Point>(" {\n\t\"label\" : \"k\", \"extra\": [1, {\"a\": \"}\"}, null], \"y\": -2, \"x\": 7 } ");
+    assert(point.x == 7 && point.y == -2 && point.label == "k");
+
+    // 转义
+    point = json.deserialize<Point>(R"({0, 0, "q\"b\\s\n\u00e9\ud83d\ude00"})");
+    assert(point.label == "q\"b\\s\n\xc3\xa9\xf0\x9f\x98\x80");
+
+    // 嵌套：编译期路径
+    Person person{"Bob", 30, 1.25, {"Paris", 75001}};
+    Person decoded = json.deserialize<Person>(json.serialize(person));
+    assert(decoded.name == "Bob" && decoded.age == 30 && decoded.score == 1.25);
+    assert(decoded.address.city == "Paris" && decoded.address.zip == 75001);
+
+    // 嵌套：Serializable 路径直接填充已有的成员对象
+    Team team;
+    team.name = "core";
+    team.leader = User("Alice", 14);
+    std::string text = json.serialize(team);
+    assert(text == "{\"core\", {\"Alice\", 14}}");
+    Team teamBack = json.deserialize<Team>(text);
+    assert(teamBack.name == "core" && teamBack.leader.name == "Alice" && teamBack.leader.age == 14);
+
+    // 错误输入
+    auto rejects = [&](const char* input, std::string_view message) {
+        try { (void)json.deserialize<Point>(input); }
+        catch (const std::invalid_argument& e) { return std::string_view(e.what()) == message; }
+        return false;
+    };
+    assert(rejects("{1, 2", "Expected '}' at offset 5"));
+    assert(rejects("{1, 2, \"x\"} trailing", "Trailing characters after object"));
+    assert(rejects("{1, \"two\", \"x\"}", "Expected a number at offset 4"));
+    assert(rejects("{1, 2, \"x\", 4}", "Too many tokens"));
+    assert(rejects("{1, 2, \"bad\\q\"}", "Invalid escape at offset 12"));
+    bool outOfRange = false;
+    try { (void)json.deserialize<Point>("{99999999999, 2, \"x\"}"); }
+    catch (const std::out_of_range&) { outOfRange = true; }
+    assert(outOfRange);
+
+    // JSON 没有 NaN / Infinity：写出时拒绝，读入时也不接受这些记号
+    for (double bad : {std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity(),
+                       -std::numeric_limits<double>::infinity()}) {
+        bool rejected = false;
+        try { (void)json.serialize(Person{"n", 1, bad}); }
+        catch (const std::invalid_argument&) { rejected = true; }
+        assert(rejected);
+    }
+    auto badScore = [&](const char* input) {
+        try { (void)json.deserialize<Person>(input); }
+        catch (const std::invalid_argument&) { return true; }
+        return false;
+    };
+    assert(badScore(R"({"n", 1, nan, {"c", 1}})"));
+    assert(badScore(R"({"n", 1, -inf, {"c", 1}})"));
+    assert(badScore(R"({"n", 1, infinity, {"c", 1}})"));
+    assert(badScore(R"({"n", 1, .5, {"c", 1}})"));
+    assert(!badScore(R"({"n", 1, -0.5e3, {"c", 1}})"));
+
+    // Benchmark
+    {
+        constexpr int N = 500000;
+        std::string input = json.serialize(person);
+        size_t sink = 0;
+        double t = timeIt([&] {
+            for (int i = 0; i < N; ++i) sink += json.deserialize<Person>(input).age;
+        });
+        assert(sink == size_t(N) * 30);
+        std::cout << "  Person x" << N << " decode: " << t << " ms ("
+                  << double(input.size()) * N / t / 1e3 << " MB/s)\n";
+    }
+
+    std::cout << "[OK] All JSON parser tests passed\n";
+}
+
+void testJSONScan() {
+    std::cout << "Running JSON scan tests...\n";
+    Serializer<JSONFormat> json;
+    const JSONScan::Level best = JSONScan::supported();
+    const char* names[] = {"scalar", "SSE2", "AVX2"};
+
+    // 每个实现与标量版本逐一比对：各种长度、命中位置，以及不应命中的高位字节
+    {
+        std::string data(200, 'a');
+        for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<char>(0x80 + i % 100);
+        const char probes[] = {'"', '\\', '\n', '\x1f', '\x20', '{', '}', '[', ']', ':', '\x7f', '\xff'};
+        for (int level = 0; level <= int(best); ++level) {
+            for (size_t n = 0; n <= 130; ++n) {
+                for (size_t pos = 0; pos <= n; pos += 7) {
+                    for (char probe : probes) {
+                        std::string copy = data;
+                        if (pos < n) copy[pos] = probe;
+                        JSONScan::setLevel(JSONScan::Level::Scalar);
+                        size_t e = JSONScan::findEscape(copy.data(), n);
+                        size_t q = JSONScan::findQuote(copy.data(), n);
+                        size_t st = JSONScan::findStructural(copy.data(), n);
+                        JSONScan::setLevel(JSONScan::Level(level));
+                        assert(JSONScan::findEscape(copy.data(), n) == e);
+                        assert(JSONScan::findQuote(copy.data(), n) == q);
+                        assert(JSONScan::findStructural(copy.data(), n) == st);
+                    }
+                }
+            }
+        }
+        JSONScan::setLevel(best);
+    }
+
+    // 所有字节值都能往返，输出里没有未转义的控制字符
+    {
+        Point point{1, 2, {}};
+        for (int i = 0; i < 256; ++i) point.label += static_cast<char>(i);
+        point.label += point.label;
+        std::string text = json.serialize(point);
+        for (char c : text) assert(static_cast<unsigned char>(c) >= 0x20);
+        assert(text.find("\\u001f") != std::string::npos && text.find("\\\"") != std::string::npos);
+        assert(json.deserialize<Point>(text).label == point.label);
+    }
+
+    // Benchmark: 长字符串的转义写出、读入，以及跳过大的未知字段
+    {
+        std::string payload;
+        for (int i = 0; i < (1 << 20); ++i) payload += (i % 4096 == 0) ? '"' : static_cast<char>('a' + i % 26);
+        Point point{1, 2, payload};
+        std::string text = json.serialize(point);
+        std::string unknown = "{\"x\": 1, \"skip\": [" ;
+        for (int i = 0; i < 2000; ++i) unknown += "{\"k\": \"" + payload.substr(0, 500) + "\", \"v\": [1, 2]}, ";
+        unknown += "0], \"y\": 2, \"label\": \"\"}";
+
+        StringWriter out;
+        constexpr int R = 20;
+        for (int level = 0; level <= int(best); ++level) {
+            JSONScan::setLevel(JSONScan::Level(level));
+            double write = timeIt([&] {
+                for (int r = 0; r < R; ++r) {
+                    out.clear();
+                    json.serialize(point, out);
+                }
+            });
+            assert(out.view() == text);
+            double read = timeIt([&] {
+                for (int r = 0; r < R; ++r) assert(json.deserialize<Point>(text).label.size() == payload.size());
+            });
+            double skip = timeIt([&] {
+                for (int r = 0; r < R; ++r) assert(json.deserialize<Point>(unknown).y == 2);
+            });
+            double mb = double(text.size()) * R / 1e6;
+            std::cout << "  " << names[level] << ": escape " << mb / write * 1e3 << " MB/s, parse "
+                      << mb / read * 1e3 << " MB/s, skip " << double(unknown.size()) * R / 1e6 / skip * 1e3 << " MB/s\n";
+        }
+        JSONScan::setLevel(best);
+    }
+
+    std::cout << "[OK] All JSON scan tests passed\n";
+}
+
+void testBinaryView() {
+    std::cout << "Running binary view tests...\n";
+    Serializer<BinaryFormat> binary;
+    Person person{"a name longer than the SSO buffer", -30, 2.5, {"Paris", 75001}};
+    const std::string bytes = binary.serialize(person);
+
+    // 按下标、按成员指针访问，嵌套对象是子视图；都不分配
+    {
+        size_t before = allocations;
+        BinaryView<Person> view{bytes};
+        std::string_view name = view.get<&Person::name>();
+        assert(name == person.name && name.data() >= bytes.data() && name.data() < bytes.data() + bytes.size());
+        assert(view.get<1>() == -30 && view.get<&Person::score>() == 2.5);
+        auto address = view.get<&Person::address>();
+        assert(address.get<&Address::city>() == "Paris" && address.get<&Address::zip>() == 75001);
+        assert(allocations == before);
+
+        // 字段偏移可以直接取出原始编码
+        assert(view.raw<0>().size() == 1 + person.name.size());
+        assert(view.raw<1>() == std::string_view("\x3b", 1));
+        assert(view.bytes() == bytes);
+
+        Person full = view.materialize();
+        assert(full.name == person.name && full.address.zip == 75001);
+    }
+
+    // 持有输入：视图活着时缓冲区不释放，移动视图后依然有效
+    {
+        MockBuffer buffer{std::make_unique<char[]>(bytes.size())};
+        std::memcpy(buffer.data(), bytes.data(), bytes.size());
+        BinaryView<Person, MockBuffer> owned{std::move(buffer), bytes.size()};
+        BinaryView<Person, MockBuffer> moved = std::move(owned);
+        assert(moved.get<&Person::name>() == person.name && moved.get<&Person::address>().get<1>() == 75001);
+
+        // SSO 字符串移动后地址会变，视图每次重新取地址
+        Point point{1, 2, "short"};
+        std::string encoded = binary.serialize(point);
+        size_t size = encoded.size();
+        BinaryView<Point, std::string> small{std::move(encoded), size};
+        BinaryView<Point, std::string> smallMoved = std::move(small);
+        assert(smallMoved.get<&Point::label>() == "short");
+    }
+
+    // 构造时检查结构，数值范围在访问时检查
+    {
+        bool threw = false;
+        try { BinaryView<Person> bad{std::string_view(bytes).substr(0, bytes.size() - 1)}; }
+        catch (const std::out_of_range&) { threw = true; }
+        assert(threw);
+        threw = false;
+        std::string trailing = bytes + "x";
+        try { BinaryView<Person> bad{trailing}; }
+        catch (const std::invalid_argument&) { threw = true; }
+        assert(threw);
+    }
+
+    // Benchmark: 过滤后丢弃，大多数消息只看两个字段
+    {
+        constexpr int N = 500000;
+        std::vector<std::string> messages;
+        for (int i = 0; i < 1000; ++i) {
+            Person p{"user-" + std::to_string(i) + "-with-a-long-display-name", i % 100, i * 0.5,
+                     {"city-" + std::to_string(i % 7) + "-outside-sso", 10000 + i}};
+            messages.push_back(binary.serialize(p));
+        }
+        size_t matchedFull = 0, matchedView = 0;
+        size_t before = allocations;
+        double tFull = timeIt([&] {
+            for (int i = 0; i < N; ++i) {
+                Person p = binary.deserialize<Person>(messages[i % messages.size()]);
+                if (p.age >= 90 && p.address.city.starts_with("city-3")) ++matchedFull;
+            }
+        });
+        size_t allocFull = allocations - before;
+        before = allocations;
+        double tView = timeIt([&] {
+            for (int i = 0; i < N; ++i) {
+                BinaryView<Person> view{messages[i % messages.size()]};
+                if (view.get<&Person::age>() >= 90 && view.get<&Person::address>().get<&Address::city>().starts_with("city-3")) ++matchedView;
+            }
+        });
+        size_t allocView = allocations - before;
+        assert(matchedFull == matchedView && matchedView > 0);
+        std::cout << "  filter x" << N << ": deserialize " << tFull << " ms (" << double(allocFull) / N
+                  << " allocs/msg), view " << tView << " ms (" << double(allocView) / N << " allocs/msg)\n";
+    }
+
+    std::cout << "[OK] All binary view tests passed\n";
+}
+
+void testContainers() {
+    std::cout << "Running container tests...\n";
+    Serializer<JSONFormat> json;
+    Serializer<BinaryFormat> binary;
+
+    Series series;
+    series.name = "s\"1";
+    series.values = {0.5, -1.25, 1e300};
+    series.ids = {1, -2, 3};
+    series.rgb = {255, 128, 0};
+    series.counts = {{"a", 1}, {"b\n", 2}};
+    series.labels = {{-1, "minus"}, {7, "seven"}};
+    series.limit = 9.5;
+    series.points = {{1, 2, "p"}, {3, 4, "q"}};
+    series.tags = {"x", "y, z"};
+
+    // 两种格式往返
+    for (const Series& s : {series, Series{}}) {
+        assert(json.deserialize<Series>(json.serialize(s)) == s);
+        assert(binary.deserialize<Series>(binary.serialize(s)) == s);
+    }
+    series.origin = Point{0, 0, "o"};
+    series.limit.reset();
+    assert(json.deserialize<Series>(json.serialize(series)) == series);
+    assert(binary.deserialize<Series>(binary.serialize(series)) == series);
+
+    // JSON 形式
+    Series small;
+    small.ids = {1, 2};
+    small.counts = {{"k", 3}};
+    small.labels = {{5, "v"}};
+    assert(json.serialize(small) ==
+           "{\"name\": \"\", \"values\": [], \"ids\": [1, 2], \"rgb\": [0, 0, 0], \"counts\": {\"k\": 3}, "
+           "\"labels\": {\"5\": \"v\"}, \"limit\": null, \"origin\": null, \"points\": [], \"tags\": []}");
+
+    // 二进制：vector<int> 为个数 + 原样的 4 字节小端值，array 不写个数
+    std::string bytes = binary.serialize(small);
+    assert(bytes.substr(0, 15) == std::string("\x00\x00\x02\x01\x00\x00\x00\x02\x00\x00\x00"
+                                              "\x00\x00\x00\x00", 15));
+
+    // Serializable 路径
+    Samples samples;
+    samples.ids = {4, 5};
+    samples.values = {0.25};
+    samples.tags = {"t"};
+    assert(json.serialize(samples) == "{[4, 5], [0.25], [\"t\"]}");
+    for (const Samples& back : {json.deserialize<Samples>(json.serialize(samples)),
+                                binary.deserialize<Samples>(binary.serialize(samples))}) {
+        assert(back.ids == samples.ids && back.values == samples.values && back.tags == samples.tags);
+    }
+
+    // 视图：容器字段解码出拷贝，其余字段照常零拷贝
+    {
+        std::string encoded = binary.serialize(series);
+        BinaryView<Series> view{encoded};
+        assert(view.get<&Series::name>() == series.name && view.get<&Series::values>() == series.values);
+        assert(view.get<&Series::origin>()->label == "o" && !view.get<&Series::limit>());
+    }
+
+    // 元素可以不占字节：个数检查按类型的最小编码长度计算，而不是固定的 1 / 2 字节
+    {
+        static_assert(minBinarySize<Empty>() == 0 && minBinarySize<Point>() == 3);
+        static_assert(minBinarySize<std::array<int32_t, 2>>() == 8 && minBinarySize<std::array<Point, 2>>() == 6);
+        Hollow hollow;
+        hollow.empties.resize(5);
+        hollow.keys = {{1, {}}, {2, {}}, {3, {}}};
+        hollow.blanks.resize(4);
+        std::string encoded = binary.serialize(hollow);
+        assert(encoded == std::string("\x05\x03\x02\x04\x06\x04", 6));
+        Hollow back = binary.deserialize<Hollow>(encoded);
+        assert(back.empties.size() == 5 && back.keys.size() == 3 && back.keys.count(3) && back.blanks.size() == 4);
+        BinaryView<Hollow> view{encoded};
+        assert(view.get<&Hollow::empties>().size() == 5 && view.get<&Hollow::keys>().size() == 3);
+        assert(view.get<&Hollow::blanks>().size() == 4);
+
+        // 不占字节的元素个数也不能随意伪造：2^40 个空元素在循环前就被拒绝
+        std::string forged("\x80\x80\x80\x80\x80\x20\x00\x00", 8);
+        auto rejects = [](auto decode) {
+            try { decode(); }
+            catch (const std::invalid_argument& e) { return std::string(e.what()) == "Too many zero-size elements"; }
+            return false;
+        };
+        assert(rejects([&] { (void)binary.deserialize<Hollow>(forged); }));
+        assert(rejects([&] { BinaryView<Hollow> bad{forged}; }));
+        std::string forgedBlanks = std::string("\x00\x00", 2) + forged.substr(0, 6);
+        assert(rejects([&] { (void)binary.deserialize<Hollow>(forgedBlanks); }));
+    }
+
+    // 伪造的元素个数不会导致巨大的预分配
+    {
+        bool threw = false;
+        try { (void)binary.deserialize<Series>(std::string("\x00\xff\xff\xff\xff\x0f", 6)); }
+        catch (const std::out_of_range&) { threw = true; }
+        assert(threw);
+        std::string badFlag = binary.serialize(small);
+        badFlag[badFlag.size() - 4] = 2;
+        threw = false;
+        try { (void)binary.deserialize<Series>(badFlag); }
+        catch (const std::invalid_argument&) { threw = true; }
+        assert(threw);
+    }
+
+    // Benchmark: 1M 元素的数值 vector
+    {
+        constexpr size_t N = 1000000;
+        Series big;
+        Series bigBack;
+        std::vector<Boxed> boxed(N);
+        std::vector<Boxed> boxedBack;
+        for (size_t i = 0; i < N; ++i) {
+            big.values.push_back(i * 0.5);
+            big.ids.push_back(static_cast<int>(i * 2654435761u));
+            boxed[i].v = i * 0.5;
+        }
+        StringWriter out;
+        constexpr int R = 10;
+
+        auto report = [&](const char* label, size_t bytes, double encode, double decode) {
+            double mb = double(bytes) * R / 1e6;
+            std::cout << "  " << label << ": " << bytes / 1000 << " KB, encode " << encode / R << " ms ("
+                      << mb / encode * 1e3 << " MB/s), decode " << decode / R << " ms (" << mb / decode * 1e3 << " MB/s)\n";
+        };
+
+        // 整段 memcpy
+        double encode = timeIt([&] {
+            for (int r = 0; r < R; ++r) {
+                out.clear();
+                binary.serialize(big, out);
+            }
+        });
+        std::string encoded{out.view()};
+        double decode = timeIt([&] {
+            for (int r = 0; r < R; ++r) bigBack = binary.deserialize<Series>(encoded);
+        });
+        assert(bigBack.values == big.values && bigBack.ids == big.ids);
+        report("binary bulk (1M double + 1M int)", encoded.size(), encode, decode);
+
+        // 逐元素：同样的 double 字节，按元素调用 writeBinary / readBinary
+        auto boxedWrite = [&](Writer& w) {
+            for (const Boxed& b : boxed) binary.serialize(b, w);
+        };
+        encode = timeIt([&] {
+            for (int r = 0; r < R; ++r) {
+                out.clear();
+                boxedWrite(out);
+            }
+        });
+        std::string boxedBytes{out.view()};
+        assert(std::string_view(boxedBytes) == std::string_view(encoded).substr(4, N * sizeof(double)));
+        decode = timeIt([&] {
+            for (int r = 0; r < R; ++r) {
+                boxedBack.clear();
+                for (size_t i = 0; i < N; ++i) {
+                    boxedBack.push_back(binary.deserialize<Boxed>(std::string_view(boxedBytes).substr(i * 8, 8)));
+                }
+            }
+        });
+        assert(boxedBack.size() == N && boxedBack[N - 1].v == boxed[N - 1].v);
+        report("binary per-element (1M double)", boxedBytes.size(), encode, decode);
+
+        // JSON 对照
+        encode = timeIt([&] {
+            for (int r = 0; r < R; ++r) {
+                out.clear();
+                json.serialize(big, out);
+            }
+        });
+        std::string text{out.view()};
+        decode = timeIt([&] {
+            for (int r = 0; r < R; ++r) bigBack = json.deserialize<Series>(text);
+        });
+        assert(bigBack.values == big.values && bigBack.ids == big.ids);
+        report("JSON (1M double + 1M int)", text.size(), encode, decode);
+    }
+
+    std::cout << "[OK] All container tests passed\n";
+}
+
 int main() {
     std::cout << Serializer<JSONFormat>().serialize(User("Alice", 14)) << std::endl;
     try {
@@ -25,5 +841,12 @@ int main() {
         std::cerr << e.what() << std::endl;
     }
 
+    testReflection();
+    testBinary();
+    testWriter();
+    testJSONParser();
+    testJSONScan();
+    testBinaryView();
+    testContainers();
     return 0;
-}
\ No newline at end of file
+}